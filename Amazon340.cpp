@@ -36,11 +36,35 @@ void Amazon340::createVendor() {
     std::cout << "Enter profile picture URL: ";
     std::getline(std::cin, profilePicture);
     
-    vendor = Vendor(username, email, password, bio, profilePicture);
+    // Vendors own their products and cannot be copied, so fill in the profile in place
+    vendor.setUsername(username);
+    vendor.setEmail(email);
+    vendor.setPassword(password);
+    vendor.setBio(bio);
+    vendor.setProfilePicture(profilePicture);
     std::cout << "Vendor profile created successfully!" << std::endl;
 }
 
 // Get the current vendor
-Vendor Amazon340::getVendor() const {
+Vendor& Amazon340::getVendor() {
     return vendor;
-}
\ No newline at end of file
+}
+
+// Marketplace revenue
+Cents Amazon340::getMarketplaceRevenue() const {
+    return vendor.getRevenue();
+}
+
+// Marketplace ratings
+RatingHistogram Amazon340::getMarketplaceRatings() const {
+    RatingHistogram ratings;
+    ratings += vendor.getRatingHistogram();
+    return ratings;
+}
+
+// Marketplace summary
+void Amazon340::displayMarketplaceSummary() const {
+    std::cout << "==== Marketplace Summary ====" << std::endl;
+    std::cout << "Total Revenue: $" << Product::formatPrice(getMarketplaceRevenue()) << std::endl;
+    getMarketplaceRatings().display(std::cout);
+}
@@ -40,9 +40,28 @@ class Amazon340 {
 
 		/**
 		 * @brief Gets the current vendor
-		 * @return The current vendor object
+		 * @return The vendor this application owns (not a copy)
 		 */
-		Vendor getVendor() const;
+		Vendor& getVendor();
+
+		/**
+		 * @brief Gets the revenue of the whole marketplace
+		 * @return The total revenue in cents, from the vendor's running total
+		 */
+		Cents getMarketplaceRevenue() const;
+
+		/**
+		 * @brief Gets the rating histogram of the whole marketplace
+		 * @return The vendor's histogram merged into a marketplace total
+		 */
+		RatingHistogram getMarketplaceRatings() const;
+
+		/**
+		 * @brief Prints the marketplace revenue and rating summary
+		 * @pre None
+		 * @post The totals are printed to std::cout; nothing walks the catalog
+		 */
+		void displayMarketplaceSummary() const;
 };
 
 #endif // AMAZON340_H
\ No newline at end of file
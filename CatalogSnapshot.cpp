@@ -0,0 +1,162 @@
+#include "CatalogSnapshot.h"
+#include <atomic>
+
+const int CatalogSnapshot::LEVEL_BITS;
+const std::size_t CatalogSnapshot::FANOUT;
+
+// ProductRecord
+ProductRecord ProductRecord::from(const Product& product) {
+    ProductRecord record;
+    record.id = product.getId();
+    record.name = product.getName();
+    record.description = product.getDescriptionText();
+    record.rating = product.getRating();
+    record.soldCount = product.getSoldCount();
+    record.price = product.getPrice();
+    record.quantity = 0;
+
+    const Good* good = dynamic_cast<const Good*>(&product);
+    record.isGood = (good != nullptr);
+    if (good != nullptr) {
+        record.expirationDate = good->getExpirationDate();
+        record.quantity = good->getQuantity();
+    } else if (const Media* media = dynamic_cast<const Media*>(&product)) {
+        record.type = media->getType();
+        record.targetAudience = media->getTargetAudience();
+    }
+    return record;
+}
+
+void ProductRecord::display(std::ostream& out) const {
+    out << "Product Name: " << name << std::endl;
+    out << "Description: " << description.load() << std::endl;
+    out << "Rating: " << rating << std::endl;
+    out << "Price: $" << Product::formatPrice(price) << std::endl;
+    out << "Sold Count: " << soldCount << std::endl;
+    if (isGood) {
+        out << "Expiration Date: " << expirationDate << std::endl;
+        out << "Quantity Available: " << quantity << std::endl;
+    } else {
+        out << "Type: " << type << std::endl;
+        out << "Target Audience: " << targetAudience << std::endl;
+    }
+}
+
+// CatalogSnapshot
+CatalogSnapshot::Node::Node(int level) {
+    if (level == 1) {
+        records.resize(FANOUT);
+    } else {
+        children.resize(FANOUT);
+    }
+}
+
+CatalogSnapshot::CatalogSnapshot() : height(1), liveCount(0), revenue(0), version(0) {}
+
+std::size_t CatalogSnapshot::size() const {
+    return liveCount;
+}
+
+Cents CatalogSnapshot::getRevenue() const {
+    return revenue;
+}
+
+std::uint64_t CatalogSnapshot::getVersion() const {
+    return version;
+}
+
+const ProductRecord* CatalogSnapshot::find(ProductId id) const {
+    std::size_t slot = static_cast<std::size_t>(id & 0xFFFFFFFFu);
+    if (id == 0 || !root || (slot >> (LEVEL_BITS * height)) != 0) {
+        return nullptr;
+    }
+    const Node* node = root.get();
+    for (int level = height; level > 1; level--) {
+        node = node->children[(slot >> (LEVEL_BITS * (level - 1))) & (FANOUT - 1)].get();
+        if (node == nullptr) {
+            return nullptr;
+        }
+    }
+    const std::shared_ptr<const ProductRecord>& record = node->records[slot & (FANOUT - 1)];
+    // The slot may hold a newer product than the one this ID named
+    if (!record || record->id != id) {
+        return nullptr;
+    }
+    return record.get();
+}
+
+// VersionedCatalog
+VersionedCatalog::VersionedCatalog() : current(std::make_shared<const CatalogSnapshot>()) {}
+
+std::shared_ptr<const CatalogSnapshot> VersionedCatalog::snapshot() const {
+    return std::atomic_load(&current);
+}
+
+void VersionedCatalog::publish(const Product& product) {
+    if (product.getId() == 0) {
+        return;
+    }
+    setSlot(product.getId(), std::make_shared<const ProductRecord>(ProductRecord::from(product)));
+}
+
+void VersionedCatalog::retire(ProductId id) {
+    if (id == 0) {
+        return;
+    }
+    setSlot(id, nullptr);
+}
+
+void VersionedCatalog::setSlot(ProductId id, std::shared_ptr<const ProductRecord> record) {
+    std::lock_guard<std::mutex> guard(writeLock);
+    std::shared_ptr<const CatalogSnapshot> old = std::atomic_load(&current);
+    if (!record && old->find(id) == nullptr) {
+        return; // Already gone from this version
+    }
+
+    // Only the snapshot header and one node per level are new; everything else is shared
+    std::size_t slot = static_cast<std::size_t>(id & 0xFFFFFFFFu);
+    std::shared_ptr<CatalogSnapshot> next = std::make_shared<CatalogSnapshot>(*old);
+    while ((slot >> (CatalogSnapshot::LEVEL_BITS * next->height)) != 0) {
+        // Grow a level: the old tree becomes the first child of a new root
+        if (next->root) {
+            std::shared_ptr<CatalogSnapshot::Node> grown = std::make_shared<CatalogSnapshot::Node>(next->height + 1);
+            grown->children[0] = next->root;
+            next->root = grown;
+        }
+        next->height++;
+    }
+
+    std::shared_ptr<const ProductRecord> previous;
+    next->root = copyPath(next->root.get(), next->height, slot, record, previous);
+    if (record && !previous) {
+        next->liveCount++;
+    } else if (!record && previous) {
+        next->liveCount--;
+    }
+    // Kept per version, so the revenue always matches the records it is read with
+    if (previous) {
+        next->revenue -= previous->price * previous->soldCount;
+    }
+    if (record) {
+        next->revenue += record->price * record->soldCount;
+    }
+    next->version = old->version + 1;
+    std::atomic_store(&current, std::shared_ptr<const CatalogSnapshot>(next));
+}
+
+std::shared_ptr<const CatalogSnapshot::Node> VersionedCatalog::copyPath(const CatalogSnapshot::Node* node, int level,
+                                                                       std::size_t slot,
+                                                                       const std::shared_ptr<const ProductRecord>& record,
+                                                                       std::shared_ptr<const ProductRecord>& previous) {
+    std::shared_ptr<CatalogSnapshot::Node> copy = (node != nullptr)
+        ? std::make_shared<CatalogSnapshot::Node>(*node)
+        : std::make_shared<CatalogSnapshot::Node>(level);
+    std::size_t index = (slot >> (CatalogSnapshot::LEVEL_BITS * (level - 1))) & (CatalogSnapshot::FANOUT - 1);
+    if (level == 1) {
+        previous = copy->records[index];
+        copy->records[index] = record;
+    } else {
+        copy->children[index] = copyPath(copy->children[index].get(), level - 1, slot, record, previous);
+    }
+    return copy;
+}
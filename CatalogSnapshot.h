@@ -0,0 +1,203 @@
+#ifndef CATALOG_SNAPSHOT_H
+#define CATALOG_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Product.h"
+
+/**
+ * @brief Immutable copy of one product's fields as of a catalog version
+ */
+struct ProductRecord {
+    ProductId id;                ///< Stable product ID
+    bool isGood;                 ///< True for Good, false for Media
+    std::string name;            ///< Product name
+    ColdText description;        ///< Product description (shared with the product)
+    int rating;                  ///< Customer rating
+    int soldCount;               ///< Units sold
+    Cents price;                 ///< Unit price in cents
+    std::string type;            ///< Media type (empty for goods)
+    std::string targetAudience;  ///< Media target audience (empty for goods)
+    std::string expirationDate;  ///< Good expiration date (empty for media)
+    int quantity;                ///< Good quantity (0 for media)
+
+    /**
+     * @brief Captures a product's current fields
+     * @param product The product to copy
+     * @return The record
+     */
+    static ProductRecord from(const Product& product);
+
+    /**
+     * @brief Prints the record in the same layout as Product::display()
+     * @param out The stream to print to
+     */
+    void display(std::ostream& out = std::cout) const;
+};
+
+/**
+ * @brief One immutable version of a vendor's catalog
+ *
+ * Records are stored by ProductId slot in a radix tree of FANOUT-way
+ * nodes, so a new version copies only the nodes on the path to the slot
+ * that changed and shares every other node with the previous version.
+ * Readers may iterate a snapshot from any thread without locking; it
+ * never changes after it is published.
+ */
+class CatalogSnapshot {
+public:
+    /// Bits of the slot index consumed per tree level
+    static const int LEVEL_BITS = 5;
+    /// Children per node; a write copies one node per level
+    static const std::size_t FANOUT = std::size_t(1) << LEVEL_BITS;
+
+    /**
+     * @brief Default constructor
+     * @post An empty snapshot at version 0
+     */
+    CatalogSnapshot();
+
+    /**
+     * @brief Gets the number of products in this version
+     * @return The live product count
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the revenue of the products in this version in O(1)
+     * @return The sum of price * soldCount over the records, in cents
+     */
+    Cents getRevenue() const;
+
+    /**
+     * @brief Gets the catalog version this snapshot captures
+     * @return The version number, incremented on every publish
+     */
+    std::uint64_t getVersion() const;
+
+    /**
+     * @brief Looks up a product record by ID in O(log n)
+     * @param id The product ID
+     * @return The record, or nullptr if the ID is not live in this version
+     */
+    const ProductRecord* find(ProductId id) const;
+
+    /**
+     * @brief Calls fn(const ProductRecord&) for every product, in ID slot order
+     * @param fn The visitor
+     */
+    template<class Fn>
+    void forEach(Fn fn) const {
+        if (root) {
+            visit(*root, height, fn);
+        }
+    }
+
+private:
+    friend class VersionedCatalog;
+
+    /// Tree node; interior nodes hold children, leaves (level 1) hold records
+    struct Node {
+        std::vector<std::shared_ptr<const Node> > children;         ///< Subtrees (interior nodes only)
+        std::vector<std::shared_ptr<const ProductRecord> > records; ///< Records by slot (leaves only)
+
+        explicit Node(int level);
+    };
+
+    std::shared_ptr<const Node> root; ///< Top of the tree (nullptr while nothing was published)
+    int height;                       ///< Levels in the tree; it covers FANOUT^height slots
+    std::size_t liveCount;            ///< Non-null records
+    Cents revenue;                    ///< Sum of price * soldCount over the records
+    std::uint64_t version;            ///< Publish counter
+
+    template<class Fn>
+    static void visit(const Node& node, int level, Fn& fn) {
+        if (level == 1) {
+            for (const std::shared_ptr<const ProductRecord>& record : node.records) {
+                if (record) {
+                    fn(*record);
+                }
+            }
+            return;
+        }
+        for (const std::shared_ptr<const Node>& child : node.children) {
+            if (child) {
+                visit(*child, level - 1, fn);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Multi-version catalog: writers publish, readers take snapshots
+ *
+ * snapshot() hands out the current version in O(1); the reader keeps it
+ * alive for as long as it holds the pointer, and a version is freed when
+ * its last reader lets go. Writers are serialized among themselves and
+ * build each new version by copying the O(log n) nodes on the path to the
+ * changed slot, then swap it in atomically, so readers never wait for
+ * writers.
+ */
+class VersionedCatalog {
+public:
+    /**
+     * @brief Default constructor
+     * @post The current version is empty
+     */
+    VersionedCatalog();
+
+    VersionedCatalog(const VersionedCatalog&) = delete;
+    VersionedCatalog& operator=(const VersionedCatalog&) = delete;
+
+    /**
+     * @brief Gets the current version
+     * @return A shared pointer to an immutable snapshot
+     */
+    std::shared_ptr<const CatalogSnapshot> snapshot() const;
+
+    /**
+     * @brief Publishes a product's current fields (insert or update)
+     * @param product The product; must have a vendor-assigned ID
+     * @post A new version containing the product's fields is current
+     */
+    void publish(const Product& product);
+
+    /**
+     * @brief Publishes a version without a product
+     * @param id The ID of the product leaving the catalog
+     * @post A new version without the product is current
+     */
+    void retire(ProductId id);
+
+private:
+    std::shared_ptr<const CatalogSnapshot> current; ///< Accessed only through std::atomic_load/store
+    std::mutex writeLock;                           ///< Serializes writers
+
+    /**
+     * @brief Publishes a version with one slot replaced
+     * @param id The product ID whose slot changes
+     * @param record The new record, or nullptr to clear the slot
+     */
+    void setSlot(ProductId id, std::shared_ptr<const ProductRecord> record);
+
+    /**
+     * @brief Copies the path from a node down to one slot, replacing the slot's record
+     * @param node The subtree to copy (nullptr for an empty subtree)
+     * @param level The subtree's level (1 for a leaf)
+     * @param slot The slot index
+     * @param record The new record, or nullptr to clear the slot
+     * @param previous Set to the record the slot held before (nullptr if none)
+     * @return The new subtree; nodes off the path are shared with the old one
+     */
+    static std::shared_ptr<const CatalogSnapshot::Node> copyPath(const CatalogSnapshot::Node* node, int level,
+                                                                 std::size_t slot,
+                                                                 const std::shared_ptr<const ProductRecord>& record,
+                                                                 std::shared_ptr<const ProductRecord>& previous);
+};
+
+#endif // CATALOG_SNAPSHOT_H
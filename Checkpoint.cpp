@@ -0,0 +1,164 @@
+#include "Checkpoint.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const std::size_t WRITE_BUFFER = 64 << 10;        // Bytes stdio gathers per write()
+const std::size_t PACE_RECORDS = 16;              // Records written between rate checks
+const std::uint64_t PACE_SLACK_NANOS = 200000;    // How far ahead of the rate the writer may run
+
+// Writes a string as <length>:<bytes>, preceded by a space
+void writeString(std::FILE* file, std::string_view text) {
+    std::fprintf(file, " %zu:", text.size());
+    std::fwrite(text.data(), 1, text.size(), file);
+}
+
+std::uint64_t nanosSince(Clock::time_point start) {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+} // namespace
+
+Checkpoint::Checkpoint() : file(nullptr), bytesPerSecond(0), running(false), stats{0, 0, 0, 0, 0} {}
+
+Checkpoint::~Checkpoint() {
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+bool Checkpoint::start(const std::vector<const Vendor*>& vendors, const std::string& path,
+                       std::size_t bytesPerSecond) {
+    if (isRunning()) {
+        std::cout << "Error: A checkpoint is already running." << std::endl;
+        return false;
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+    Clock::time_point captureStart = Clock::now();
+    this->path = path;
+    this->bytesPerSecond = bytesPerSecond;
+    temporaryPath = path + ".tmp";
+    file = std::fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr) {
+        std::cout << "Error: Could not create " << temporaryPath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER);
+
+    // Everything the writer needs, so the vendors are free to change from here on.
+    // The revenue is read from the snapshot, so it always matches the products written
+    images.clear();
+    stats = CheckpointStats{vendors.size(), 0, 0, 0, 0};
+    for (const Vendor* vendor : vendors) {
+        VendorImage image;
+        image.username = vendor->getUsername();
+        image.email = vendor->getEmail();
+        image.bio = vendor->getBio().text();
+        image.profilePicture = vendor->getProfilePicture().text();
+        image.catalog = vendor->getCatalogSnapshot();
+        stats.products += image.catalog->size();
+        images.push_back(std::move(image));
+    }
+    error.clear();
+    running.store(true, std::memory_order_release);
+    stats.captureNanos = nanosSince(captureStart);
+    writer = std::thread(&Checkpoint::writeImage, this);
+    return true;
+}
+
+bool Checkpoint::isRunning() const {
+    return running.load(std::memory_order_acquire);
+}
+
+bool Checkpoint::wait() {
+    if (writer.joinable()) {
+        writer.join();
+    }
+    if (!error.empty()) {
+        std::cout << "Error: Checkpoint to " << path << " failed: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+CheckpointStats Checkpoint::getStats() const {
+    return stats;
+}
+
+void Checkpoint::writeImage() {
+    Clock::time_point writeStart = Clock::now();
+    std::fprintf(file, "AMAZON340-CHECKPOINT 1\n");
+    for (const VendorImage& image : images) {
+        std::fprintf(file, "V %llu %zu %lld", static_cast<unsigned long long>(image.catalog->getVersion()),
+                     image.catalog->size(), static_cast<long long>(image.catalog->getRevenue()));
+        writeString(file, image.username);
+        writeString(file, image.email);
+        writeString(file, image.bio);
+        writeString(file, image.profilePicture);
+        std::fputc('\n', file);
+
+        std::size_t records = 0;
+        image.catalog->forEach([this, &records, writeStart](const ProductRecord& record) {
+            if (++records % PACE_RECORDS == 0) {
+                pace(writeStart);
+            }
+            std::fprintf(file, "P %llu %s %d %lld %d", static_cast<unsigned long long>(record.id),
+                         record.isGood ? "good" : "media", record.rating, static_cast<long long>(record.price),
+                         record.soldCount);
+            writeString(file, record.name);
+            writeString(file, record.description.load().text());
+            if (record.isGood) {
+                writeString(file, record.expirationDate);
+                std::fprintf(file, " %d\n", record.quantity);
+            } else {
+                writeString(file, record.type);
+                writeString(file, record.targetAudience);
+                std::fputc('\n', file);
+            }
+        });
+    }
+    std::fprintf(file, "END %zu %zu\n", stats.vendors, stats.products);
+
+    long size = std::ftell(file);
+    if (std::ferror(file) || std::fflush(file) != 0 || fsync(fileno(file)) != 0) {
+        error = std::string("write: ") + std::strerror(errno);
+    }
+    if (std::fclose(file) != 0 && error.empty()) {
+        error = std::string("close: ") + std::strerror(errno);
+    }
+    file = nullptr;
+    if (error.empty() && std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        error = std::string("rename: ") + std::strerror(errno);
+    }
+    if (!error.empty()) {
+        std::remove(temporaryPath.c_str());
+    }
+
+    // The snapshots are released here, on the writer, rather than by the next start()
+    images.clear();
+    stats.bytes = (size > 0) ? static_cast<std::size_t>(size) : 0;
+    stats.writeNanos = nanosSince(writeStart);
+    running.store(false, std::memory_order_release);
+}
+
+void Checkpoint::pace(Clock::time_point start) const {
+    if (bytesPerSecond == 0) {
+        return;
+    }
+    long written = std::ftell(file);
+    std::uint64_t due = static_cast<std::uint64_t>(written) * 1000000000ull / bytesPerSecond;
+    std::uint64_t elapsed = nanosSince(start);
+    if (due > elapsed + PACE_SLACK_NANOS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(due - elapsed));
+    }
+}
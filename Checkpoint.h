@@ -0,0 +1,139 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CatalogSnapshot.h"
+#include "Vendor.h"
+
+/**
+ * @brief Sizes and timings of one checkpoint
+ */
+struct CheckpointStats {
+    std::size_t vendors;        ///< Vendors in the image
+    std::size_t products;       ///< Product records in the image
+    std::size_t bytes;          ///< Size of the image file
+    std::uint64_t captureNanos; ///< Time start() spent on the caller's thread
+    std::uint64_t writeNanos;   ///< Time the background thread spent writing and syncing
+};
+
+/**
+ * @brief Writes a point-in-time image of vendors to disk in the background
+ *
+ * start() captures each vendor's profile and its current catalog snapshot,
+ * which takes a few microseconds per vendor, then returns while a
+ * background thread streams the image to a file. The snapshots are
+ * immutable, so the vendors may keep selling, creating and deleting
+ * products during the write: those changes publish new versions and never
+ * wait for the checkpoint. The only cost to them is the memory of the old
+ * tree nodes the checkpoint still holds. The image is written to a temporary
+ * file, synced and renamed over the target, so the file at the target
+ * path is always a complete checkpoint.
+ *
+ * When the writer shares a core with the selling thread, the scheduler
+ * can stall a sell for a full time slice while the writer runs. A rate
+ * limit makes the writer work in short bursts and sleep in between, so
+ * each stall is bounded by one burst at the cost of a longer checkpoint.
+ *
+ * The file is text. Strings are written as their length, a colon and the
+ * bytes, so they may contain any character:
+ *
+ *     AMAZON340-CHECKPOINT 1
+ *     V <version> <products> <revenue> <username> <email> <bio> <picture>
+ *     P <id> media <rating> <price> <sold> <name> <description> <type> <audience>
+ *     P <id> good <rating> <price> <sold> <name> <description> <expiration> <quantity>
+ *     END <vendors> <products>
+ *
+ * Each V line is followed by that vendor's P lines.
+ */
+class Checkpoint {
+public:
+    /**
+     * @brief Default constructor
+     * @post No checkpoint is running
+     */
+    Checkpoint();
+
+    /**
+     * @brief Destructor
+     * @post A running checkpoint has finished
+     */
+    ~Checkpoint();
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    /**
+     * @brief Captures the vendors and starts writing them to a file
+     * @param vendors The vendors to include, in order
+     * @param path The checkpoint file; replaced when the write completes
+     * @param bytesPerSecond Write rate limit, or 0 to write as fast as possible
+     * @pre No checkpoint is running on this object; no other thread changes the vendors' profiles
+     *      during the call (sells and product changes may continue)
+     * @post The image no longer refers to the vendors, which may change or be destroyed
+     * @return True if the write started, false otherwise (an error is printed)
+     */
+    bool start(const std::vector<const Vendor*>& vendors, const std::string& path, std::size_t bytesPerSecond = 0);
+
+    /**
+     * @brief Checks whether the background write is still in progress
+     * @pre Safe to call from any thread
+     * @return True until the image is written or has failed
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Waits for the background write to finish
+     * @post The checkpoint is not running
+     * @return True if the image was written, false otherwise (an error is printed)
+     */
+    bool wait();
+
+    /**
+     * @brief Gets the sizes and timings of the last checkpoint
+     * @pre wait() has returned
+     * @return The statistics
+     */
+    CheckpointStats getStats() const;
+
+private:
+    /// One vendor as of start()
+    struct VendorImage {
+        std::string username;                            ///< Vendor username
+        std::string email;                               ///< Vendor email
+        std::string bio;                                 ///< Vendor bio
+        std::string profilePicture;                      ///< Vendor profile picture path
+        std::shared_ptr<const CatalogSnapshot> catalog;  ///< The vendor's products
+    };
+
+    std::vector<VendorImage> images;  ///< What the background thread writes
+    std::string path;                 ///< Target file
+    std::string temporaryPath;        ///< File being written, renamed to path when complete
+    std::FILE* file;                  ///< Open temporary file while running
+    std::size_t bytesPerSecond;       ///< Write rate limit (0: unlimited)
+    std::thread writer;               ///< Background thread
+    std::atomic<bool> running;        ///< True while the writer has work left
+    std::string error;                ///< Why the write failed (empty on success)
+    CheckpointStats stats;            ///< Filled in by start() and the writer
+
+    /**
+     * @brief Writes, syncs and renames the image (runs on the writer thread)
+     * @post running is false; error is set on failure
+     */
+    void writeImage();
+
+    /**
+     * @brief Sleeps while the writer is ahead of the rate limit
+     * @param start When the write began
+     */
+    void pace(std::chrono::steady_clock::time_point start) const;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,476 @@
+#include "ColdText.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "TextDictionary.h"
+
+namespace {
+
+const std::uint64_t HANDLE_COUNT = 1;                        ///< One ColdText in ColdTextEntry::counts
+const std::uint64_t VIEW_COUNT = std::uint64_t(1) << 32;     ///< One ColdText::View in ColdTextEntry::counts
+
+} // namespace
+
+/// One stored text. Fields without their own atomics are guarded by the store's lock.
+struct ColdTextEntry {
+    std::atomic<std::uint64_t> counts;  ///< Handles (low 32 bits) and pinning views (high 32 bits)
+    std::atomic<bool> resident;         ///< characters may be read by a new view
+    std::atomic<bool> referenced;       ///< Loaded since the clock hand last passed (second chance)
+    char* characters;                   ///< The text while it is in memory (nullptr: paged out or dropped)
+    std::size_t length;                 ///< Number of characters
+    bool discardable;                   ///< Dropped rather than paged out when evicted
+    bool inFile;                        ///< Already written to the backing file
+    std::uint64_t fileOffset;           ///< Position in the backing file, if inFile
+    char* compressed;                   ///< Compressed copy kept in memory (nullptr: none)
+    std::uint32_t compressedLength;     ///< Size of the compressed copy
+    std::uint32_t dictionary;           ///< Index of its dictionary in the store
+    ColdTextEntry* newer;               ///< Next resident entry towards the clock's tail
+    ColdTextEntry* older;               ///< Next resident entry towards the clock hand
+};
+
+namespace {
+
+// Resident entries in clock order plus the backing file
+struct ColdTextRegistry {
+    std::mutex lock;
+    std::size_t budget = SIZE_MAX;
+    ColdTextEntry* newest = nullptr;
+    ColdTextEntry* oldest = nullptr;
+    std::size_t entries = 0;
+    std::size_t residentEntries = 0;
+    std::size_t residentBytes = 0;
+    std::size_t pagedOutBytes = 0;
+    std::uint64_t pageIns = 0;
+    std::uint64_t evictions = 0;
+    std::FILE* file = nullptr;
+    std::size_t fileBytes = 0;
+    bool fileFailed = false;
+    std::vector<std::shared_ptr<const TextDictionary> > dictionaries; // Every dictionary an entry may use
+    bool compressing = false;           // Evictions compress with dictionaries.back()
+    std::size_t compressedTextBytes = 0;
+    std::size_t compressedBytes = 0;
+    std::uint64_t decompressions = 0;
+    std::uint64_t decompressedBytes = 0;
+    std::uint64_t decompressNanos = 0;
+};
+
+ColdTextRegistry& registry() {
+    // Leaked on purpose so handles in static objects never see a destroyed store
+    static ColdTextRegistry* instance = new ColdTextRegistry();
+    return *instance;
+}
+
+void unlink(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    (entry->newer != nullptr ? entry->newer->older : reg.newest) = entry->older;
+    (entry->older != nullptr ? entry->older->newer : reg.oldest) = entry->newer;
+    entry->newer = nullptr;
+    entry->older = nullptr;
+}
+
+void pushNewest(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    entry->older = reg.newest;
+    entry->newer = nullptr;
+    (reg.newest != nullptr ? reg.newest->newer : reg.oldest) = entry;
+    reg.newest = entry;
+}
+
+// Appends an entry's characters to the backing file, creating it on first use
+bool writeToFile(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    if (reg.fileFailed) {
+        return false;
+    }
+    if (reg.file == nullptr) {
+        reg.file = std::tmpfile();
+        if (reg.file == nullptr) {
+            reg.fileFailed = true;
+            std::cout << "Could not create the cold text file; texts stay in memory." << std::endl;
+            return false;
+        }
+    }
+    if (std::fseek(reg.file, static_cast<long>(reg.fileBytes), SEEK_SET) != 0
+        || std::fwrite(entry->characters, 1, entry->length, reg.file) != entry->length) {
+        reg.fileFailed = true;
+        std::cout << "Could not write to the cold text file; texts stay in memory." << std::endl;
+        return false;
+    }
+    entry->fileOffset = reg.fileBytes;
+    entry->inFile = true;
+    reg.fileBytes += entry->length;
+    return true;
+}
+
+// Keeps a compressed copy of an entry if the current dictionary makes it smaller
+bool compressEntry(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    if (!reg.compressing) {
+        return false;
+    }
+    std::string block;
+    reg.dictionaries.back()->compress(std::string_view(entry->characters, entry->length), block);
+    if (block.size() >= entry->length) {
+        return false;
+    }
+    entry->compressed = new char[block.size()];
+    std::memcpy(entry->compressed, block.data(), block.size());
+    entry->compressedLength = static_cast<std::uint32_t>(block.size());
+    entry->dictionary = static_cast<std::uint32_t>(reg.dictionaries.size() - 1);
+    reg.compressedTextBytes += entry->length;
+    reg.compressedBytes += block.size();
+    return true;
+}
+
+// Makes sure an evicted entry can be loaded again: compressed, in the file, or rebuildable
+bool saveCopy(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    return entry->discardable || entry->inFile || entry->compressed != nullptr
+        || compressEntry(reg, entry) || writeToFile(reg, entry);
+}
+
+// Frees an entry's characters unless a view pins them or they cannot be saved
+bool tryEvict(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    // Pairs with pin(): either the view sees resident == false or we see its count
+    entry->resident.store(false, std::memory_order_seq_cst);
+    if ((entry->counts.load(std::memory_order_seq_cst) >> 32) != 0 || !saveCopy(reg, entry)) {
+        entry->resident.store(true, std::memory_order_seq_cst);
+        return false;
+    }
+    unlink(reg, entry);
+    delete[] entry->characters;
+    entry->characters = nullptr;
+    reg.residentEntries--;
+    reg.residentBytes -= entry->length;
+    if (!entry->discardable && entry->compressed == nullptr) {
+        reg.pagedOutBytes += entry->length;
+    }
+    reg.evictions++;
+    return true;
+}
+
+// Runs the clock hand until the budget is met, never evicting keep
+void evictOverBudget(ColdTextRegistry& reg, const ColdTextEntry* keep) {
+    // Every entry gets at most one second chance, so pinned entries cannot loop forever
+    std::size_t steps = 2 * reg.residentEntries;
+    while (reg.residentBytes > reg.budget && reg.oldest != nullptr && steps-- > 0) {
+        ColdTextEntry* entry = reg.oldest;
+        bool used = entry->referenced.exchange(false, std::memory_order_relaxed);
+        if (entry == keep || used || !tryEvict(reg, entry)) {
+            unlink(reg, entry);
+            pushNewest(reg, entry);
+        }
+    }
+}
+
+// Decompresses an entry's compressed copy into its character buffer
+void decompressEntry(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool decoded = reg.dictionaries[entry->dictionary]->decompress(
+        std::string_view(entry->compressed, entry->compressedLength), entry->characters, entry->length);
+    reg.decompressNanos += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    reg.decompressions++;
+    reg.decompressedBytes += entry->length;
+    if (!decoded) {
+        std::cout << "Could not decompress a cold text." << std::endl;
+        std::memset(entry->characters, ' ', entry->length);
+    }
+}
+
+// Brings an evicted entry back into memory from its compressed copy or the file
+void pageIn(ColdTextRegistry& reg, ColdTextEntry* entry) {
+    entry->characters = new char[entry->length];
+    if (entry->compressed != nullptr) {
+        decompressEntry(reg, entry);
+    } else {
+        if (std::fseek(reg.file, static_cast<long>(entry->fileOffset), SEEK_SET) != 0
+            || std::fread(entry->characters, 1, entry->length, reg.file) != entry->length) {
+            std::cout << "Could not read from the cold text file." << std::endl;
+            std::memset(entry->characters, ' ', entry->length);
+        }
+        reg.pagedOutBytes -= entry->length;
+    }
+    reg.residentEntries++;
+    reg.residentBytes += entry->length;
+    reg.pageIns++;
+    pushNewest(reg, entry);
+    entry->resident.store(true, std::memory_order_seq_cst);
+    evictOverBudget(reg, entry);
+}
+
+// Pins a resident entry without the lock; fails if it is paged out or being evicted
+bool pin(ColdTextEntry* entry) {
+    entry->counts.fetch_add(VIEW_COUNT, std::memory_order_seq_cst);
+    if (!entry->resident.load(std::memory_order_seq_cst)) {
+        entry->counts.fetch_sub(VIEW_COUNT, std::memory_order_relaxed);
+        return false;
+    }
+    if (!entry->referenced.load(std::memory_order_relaxed)) {
+        entry->referenced.store(true, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+ColdTextEntry* createEntry(std::string_view text, bool discardable) {
+    if (text.empty()) {
+        return nullptr;
+    }
+    ColdTextEntry* entry = new ColdTextEntry();
+    entry->counts.store(HANDLE_COUNT, std::memory_order_relaxed);
+    entry->resident.store(true, std::memory_order_relaxed);
+    entry->referenced.store(false, std::memory_order_relaxed);
+    entry->characters = new char[text.size()];
+    std::memcpy(entry->characters, text.data(), text.size());
+    entry->length = text.size();
+    entry->discardable = discardable;
+    entry->inFile = false;
+    entry->fileOffset = 0;
+    entry->compressed = nullptr;
+    entry->compressedLength = 0;
+    entry->dictionary = 0;
+
+    ColdTextRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.entries++;
+    reg.residentEntries++;
+    reg.residentBytes += entry->length;
+    pushNewest(reg, entry);
+    evictOverBudget(reg, entry);
+    return entry;
+}
+
+// Drops handle or view counts and frees the entry after the last one
+void dropCounts(ColdTextEntry* entry, std::uint64_t amount) {
+    if (entry->counts.fetch_sub(amount, std::memory_order_acq_rel) != amount) {
+        return;
+    }
+    ColdTextRegistry& reg = registry();
+    {
+        std::lock_guard<std::mutex> guard(reg.lock);
+        if (entry->characters != nullptr) {
+            unlink(reg, entry);
+            reg.residentEntries--;
+            reg.residentBytes -= entry->length;
+        } else if (!entry->discardable && entry->compressed == nullptr) {
+            reg.pagedOutBytes -= entry->length;
+        }
+        if (entry->compressed != nullptr) {
+            reg.compressedTextBytes -= entry->length;
+            reg.compressedBytes -= entry->compressedLength;
+        }
+        reg.entries--;
+    }
+    delete[] entry->characters;
+    delete[] entry->compressed;
+    delete entry;
+}
+
+} // namespace
+
+// ColdText::View
+ColdText::View::View() : entry(nullptr) {}
+
+ColdText::View::View(const View& other) : entry(other.entry) {
+    if (entry != nullptr) {
+        entry->counts.fetch_add(VIEW_COUNT, std::memory_order_relaxed);
+    }
+}
+
+ColdText::View::View(View&& other) noexcept : entry(other.entry) {
+    other.entry = nullptr;
+}
+
+ColdText::View& ColdText::View::operator=(const View& other) {
+    if (entry != other.entry) {
+        if (other.entry != nullptr) {
+            other.entry->counts.fetch_add(VIEW_COUNT, std::memory_order_relaxed);
+        }
+        reset();
+        entry = other.entry;
+    }
+    return *this;
+}
+
+ColdText::View& ColdText::View::operator=(View&& other) noexcept {
+    if (this != &other) {
+        reset();
+        entry = other.entry;
+        other.entry = nullptr;
+    }
+    return *this;
+}
+
+ColdText::View::~View() {
+    reset();
+}
+
+void ColdText::View::reset() {
+    if (entry != nullptr) {
+        dropCounts(entry, VIEW_COUNT);
+        entry = nullptr;
+    }
+}
+
+std::string_view ColdText::View::text() const {
+    return entry != nullptr ? std::string_view(entry->characters, entry->length) : std::string_view();
+}
+
+ColdText::View::operator std::string_view() const {
+    return text();
+}
+
+std::size_t ColdText::View::size() const {
+    return entry != nullptr ? entry->length : 0;
+}
+
+bool ColdText::View::empty() const {
+    return size() == 0;
+}
+
+std::ostream& operator<<(std::ostream& out, const ColdText::View& view) {
+    return out << view.text();
+}
+
+// ColdText
+ColdText::ColdText() : entry(nullptr) {}
+
+ColdText::ColdText(std::string_view text) : entry(createEntry(text, false)) {}
+
+ColdText::ColdText(const ColdText& other) : entry(other.entry) {
+    if (entry != nullptr) {
+        entry->counts.fetch_add(HANDLE_COUNT, std::memory_order_relaxed);
+    }
+}
+
+ColdText::ColdText(ColdText&& other) noexcept : entry(other.entry) {
+    other.entry = nullptr;
+}
+
+ColdText& ColdText::operator=(const ColdText& other) {
+    if (entry != other.entry) {
+        if (other.entry != nullptr) {
+            other.entry->counts.fetch_add(HANDLE_COUNT, std::memory_order_relaxed);
+        }
+        release();
+        entry = other.entry;
+    }
+    return *this;
+}
+
+ColdText& ColdText::operator=(ColdText&& other) noexcept {
+    if (this != &other) {
+        release();
+        entry = other.entry;
+        other.entry = nullptr;
+    }
+    return *this;
+}
+
+ColdText::~ColdText() {
+    release();
+}
+
+ColdText ColdText::discardable(std::string_view text) {
+    ColdText handle;
+    handle.entry = createEntry(text, true);
+    return handle;
+}
+
+void ColdText::assign(std::string_view text) {
+    ColdTextEntry* replacement = createEntry(text, false);
+    release();
+    entry = replacement;
+}
+
+ColdText::View ColdText::load() const {
+    View view;
+    loadIfResident(view);
+    return view;
+}
+
+bool ColdText::loadIfResident(View& view) const {
+    view.reset();
+    if (entry == nullptr) {
+        return true;
+    }
+    if (!pin(entry)) {
+        ColdTextRegistry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        if (entry->characters == nullptr) {
+            if (entry->discardable) {
+                return false;
+            }
+            pageIn(reg, entry);
+        }
+        // Eviction needs the lock, so the entry stays resident while it is pinned here
+        entry->counts.fetch_add(VIEW_COUNT, std::memory_order_seq_cst);
+    }
+    view.entry = entry;
+    return true;
+}
+
+std::size_t ColdText::size() const {
+    return entry != nullptr ? entry->length : 0;
+}
+
+void ColdText::release() {
+    if (entry != nullptr) {
+        dropCounts(entry, HANDLE_COUNT);
+        entry = nullptr;
+    }
+}
+
+// ColdTextStore
+void ColdTextStore::setBudget(std::size_t bytes) {
+    ColdTextRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.budget = bytes;
+    evictOverBudget(reg, nullptr);
+}
+
+std::size_t ColdTextStore::getBudget() {
+    ColdTextRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    return reg.budget;
+}
+
+void ColdTextStore::useDictionary(std::shared_ptr<const TextDictionary> dictionary) {
+    ColdTextRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.compressing = (dictionary != nullptr);
+    if (dictionary != nullptr) {
+        reg.dictionaries.push_back(dictionary);
+    }
+}
+
+ColdTextStats ColdTextStore::getStats() {
+    ColdTextRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    return ColdTextStats{reg.entries, reg.residentBytes, reg.pagedOutBytes, reg.fileBytes,
+                         reg.pageIns, reg.evictions, reg.compressedTextBytes, reg.compressedBytes,
+                         reg.decompressions, reg.decompressedBytes, reg.decompressNanos};
+}
+
+void ColdTextStore::display(std::ostream& out) {
+    ColdTextStats stats = getStats();
+    std::size_t budget = getBudget();
+    out << "Cold text:      " << stats.entries << " texts, " << stats.residentBytes << " bytes resident (budget: ";
+    if (budget == SIZE_MAX) {
+        out << "unlimited";
+    } else {
+        out << budget << " bytes";
+    }
+    out << "), " << stats.pagedOutBytes << " bytes paged out" << std::endl;
+    out << "Cold paging:    " << stats.pageIns << " page-ins, " << stats.evictions << " evictions, "
+        << stats.fileBytes << " bytes in the backing file" << std::endl;
+    if (stats.compressedTextBytes > 0) {
+        out << "Compression:    " << stats.compressedTextBytes << " bytes of text in " << stats.compressedBytes
+            << " bytes (" << static_cast<double>(stats.compressedTextBytes) / stats.compressedBytes << "x)";
+        if (stats.decompressNanos > 0) {
+            out << ", decompressing at "
+                << static_cast<std::uint64_t>(stats.decompressedBytes * 1000.0 / stats.decompressNanos) << " MB/s";
+        }
+        out << std::endl;
+    }
+}
@@ -0,0 +1,274 @@
+#ifndef COLD_TEXT_H
+#define COLD_TEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string_view>
+
+struct ColdTextEntry;
+class TextDictionary;
+
+/**
+ * @brief Totals reported by ColdTextStore
+ */
+struct ColdTextStats {
+    std::size_t entries;        ///< Live texts
+    std::size_t residentBytes;  ///< Characters held in memory
+    std::size_t pagedOutBytes;  ///< Characters held only in the backing file
+    std::size_t fileBytes;      ///< Size of the backing file
+    std::uint64_t pageIns;      ///< Texts read back from the backing file or decompressed
+    std::uint64_t evictions;    ///< Texts dropped from memory to stay within the budget
+    std::size_t compressedTextBytes; ///< Characters of the texts kept compressed in memory
+    std::size_t compressedBytes;     ///< Size of their compressed blocks
+    std::uint64_t decompressions;    ///< Blocks decompressed on access
+    std::uint64_t decompressedBytes; ///< Characters those decompressions produced
+    std::uint64_t decompressNanos;   ///< Time spent decompressing
+};
+
+/**
+ * @brief Handle to a large, rarely read text kept in the cold store
+ *
+ * The handle is one pointer wide, so an object can hold its cold text
+ * without the characters sitting next to its hot fields. A text never
+ * changes once stored: assign() switches the handle to a new text, and
+ * copies of a handle share the same text. The characters are loaded on
+ * access and may be paged out to disk when ColdTextStore is over budget.
+ * Handles may be copied, loaded and released from any thread.
+ */
+class ColdText {
+public:
+    /**
+     * @brief Read access to a loaded text
+     *
+     * A view pins the text in memory, so it is never evicted while a view
+     * of it exists, and keeps it alive if its handle is reassigned meanwhile.
+     * Views are meant to be short-lived.
+     */
+    class View {
+    public:
+        /**
+         * @brief Default constructor
+         * @post The view is empty
+         */
+        View();
+
+        /**
+         * @brief Copy constructor
+         * @param other The view to pin the text of
+         */
+        View(const View& other);
+
+        /**
+         * @brief Move constructor
+         * @param other The view to take the pin from; it is left empty
+         */
+        View(View&& other) noexcept;
+
+        /**
+         * @brief Copy assignment operator
+         * @param other The view to pin the text of
+         * @return A reference to this view
+         */
+        View& operator=(const View& other);
+
+        /**
+         * @brief Move assignment operator
+         * @param other The view to take the pin from; it is left empty
+         * @return A reference to this view
+         */
+        View& operator=(View&& other) noexcept;
+
+        /**
+         * @brief Destructor
+         * @post The text may be evicted again once no view pins it
+         */
+        ~View();
+
+        /**
+         * @brief Gets the characters
+         * @return The text, valid while this view exists
+         */
+        std::string_view text() const;
+
+        /**
+         * @brief Converts to the characters, as text() does
+         */
+        operator std::string_view() const;
+
+        /**
+         * @brief Gets the text length
+         * @return The number of characters
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Checks whether the text is empty
+         * @return True if there are no characters
+         */
+        bool empty() const;
+
+    private:
+        friend class ColdText;
+        ColdTextEntry* entry; ///< Pinned entry (nullptr: empty)
+
+        /**
+         * @brief Unpins the text
+         * @post entry is nullptr
+         */
+        void reset();
+    };
+
+    /**
+     * @brief Default constructor
+     * @post The handle holds the empty text, which needs no entry in the store
+     */
+    ColdText();
+
+    /**
+     * @brief Stores a text
+     * @param text The characters
+     * @post The text is resident and counted against the store's budget
+     */
+    explicit ColdText(std::string_view text);
+
+    /**
+     * @brief Copy constructor
+     * @param other The handle to share the text of
+     */
+    ColdText(const ColdText& other);
+
+    /**
+     * @brief Move constructor
+     * @param other The handle to take the text from; it is left holding the empty text
+     */
+    ColdText(ColdText&& other) noexcept;
+
+    /**
+     * @brief Copy assignment operator
+     * @param other The handle to share the text of
+     * @return A reference to this handle
+     */
+    ColdText& operator=(const ColdText& other);
+
+    /**
+     * @brief Move assignment operator
+     * @param other The handle to take the text from; it is left holding the empty text
+     * @return A reference to this handle
+     */
+    ColdText& operator=(ColdText&& other) noexcept;
+
+    /**
+     * @brief Destructor
+     * @post The text is removed from the store once no handle refers to it
+     */
+    ~ColdText();
+
+    /**
+     * @brief Stores a text that can be rebuilt, such as a rendering cache
+     * @param text The characters
+     * @return The handle. When evicted, the text is dropped instead of paged
+     *         out, and loadIfResident() fails from then on
+     */
+    static ColdText discardable(std::string_view text);
+
+    /**
+     * @brief Switches the handle to a new text
+     * @param text The characters
+     * @post Other handles sharing the old text keep it
+     */
+    void assign(std::string_view text);
+
+    /**
+     * @brief Loads the text, reading it back from disk if it was paged out
+     * @return A view of the text; empty if a discardable text was dropped
+     */
+    View load() const;
+
+    /**
+     * @brief Loads the text only if it is still available
+     * @param view Receives the text on success
+     * @return False if a discardable text was dropped, true otherwise
+     */
+    bool loadIfResident(View& view) const;
+
+    /**
+     * @brief Gets the text length without loading it
+     * @return The number of characters
+     */
+    std::size_t size() const;
+
+private:
+    ColdTextEntry* entry; ///< Shared entry in the store (nullptr: empty text)
+
+    /**
+     * @brief Drops this handle's reference to its entry
+     * @post entry is nullptr; the entry is freed if this was its last handle
+     */
+    void release();
+};
+
+/**
+ * @brief Prints a loaded text
+ * @param out The stream to print to
+ * @param view The text
+ * @return out
+ */
+std::ostream& operator<<(std::ostream& out, const ColdText::View& view);
+
+/**
+ * @brief Process-wide store behind every ColdText
+ *
+ * When resident texts exceed the budget, the least recently used ones
+ * (approximated with second-chance "clock" bits) are written once to an
+ * unlinked temporary file and their memory is freed; the next load reads
+ * them back. Texts are immutable, so a paged-out text is never written
+ * twice. File space of released texts is not reused. Loading a resident
+ * text takes no lock; paging in and out is serialized by one mutex.
+ * The budget is unlimited by default, in which case nothing is ever paged
+ * out and no file is created.
+ *
+ * With a dictionary in use (see useDictionary()), an evicted text is
+ * compressed and kept in memory instead of written to the file, and
+ * loading it decompresses the block. The budget then bounds only the
+ * decompressed copies; the compressed blocks stay in memory.
+ */
+class ColdTextStore {
+public:
+    /**
+     * @brief Sets the memory budget for resident text
+     * @param bytes The most characters to keep in memory
+     * @post Texts beyond the budget are paged out at once
+     */
+    static void setBudget(std::size_t bytes);
+
+    /**
+     * @brief Gets the memory budget for resident text
+     * @return The budget in bytes (SIZE_MAX when unlimited)
+     */
+    static std::size_t getBudget();
+
+    /**
+     * @brief Compresses texts with a dictionary when they are evicted
+     * @param dictionary The dictionary, or nullptr to page texts out to disk again
+     * @post Texts evicted from now on are compressed with the dictionary,
+     *       unless that does not make them smaller. Texts already compressed
+     *       keep their dictionary, which the store holds on to.
+     */
+    static void useDictionary(std::shared_ptr<const TextDictionary> dictionary);
+
+    /**
+     * @brief Gets the store's current totals
+     * @return Entry count, resident and paged-out bytes, and paging counts
+     */
+    static ColdTextStats getStats();
+
+    /**
+     * @brief Prints the store's current totals
+     * @param out The stream to print to
+     */
+    static void display(std::ostream& out = std::cout);
+};
+
+#endif // COLD_TEXT_H
@@ -0,0 +1,155 @@
+/** Counting Bloom filter for fast negative membership tests.
+	 @file CountingBloomFilter.h */
+#ifndef COUNTING_BLOOM_FILTER_
+#define COUNTING_BLOOM_FILTER_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Answers "definitely absent" or "possibly present" for items hashed with
+// std::hash. Each item bumps hashCount counters; an item is possibly
+// present only if all of its counters are nonzero, so a miss usually costs
+// one or two cache lines. Counters (rather than bits) let remove() undo an
+// add(). A counter that reaches 255 stays there, so it can only cause a
+// false positive, never a false negative.
+template<class ItemType>
+class CountingBloomFilter
+{
+public:
+   // Sizes the filter so that capacity items give about falsePositiveRate.
+   CountingBloomFilter(std::size_t capacity, double falsePositiveRate);
+
+   void add(const ItemType& item);
+   void remove(const ItemType& item);
+   bool mightContain(const ItemType& item) const;
+   void clear();
+
+   std::size_t getCapacity() const;
+   double getTargetRate() const;
+   std::size_t getCounterCount() const;
+   int getHashCount() const;
+
+   // The false-positive rate predicted for a filter holding itemCount items.
+   double expectedRate(std::size_t itemCount) const;
+
+private:
+   std::vector<std::uint8_t> counters;
+   std::size_t capacity;
+   double targetRate;
+   int hashCount;
+
+   // Two independent hashes of the item; probe i is first + i * second.
+   void hashPair(const ItemType& item, std::uint64_t& first, std::uint64_t& second) const;
+}; // end CountingBloomFilter
+
+template<class ItemType>
+CountingBloomFilter<ItemType>::CountingBloomFilter(std::size_t capacity, double falsePositiveRate)
+   : capacity(capacity < 1 ? 1 : capacity),
+     targetRate(falsePositiveRate)
+{
+   // Optimal sizing: m = -n ln p / (ln 2)^2 counters and k = (m / n) ln 2 hashes
+   double rate = std::fmin(std::fmax(falsePositiveRate, 1e-9), 0.5);
+   double ln2 = std::log(2.0);
+   double counterCount = std::ceil(-static_cast<double>(this->capacity) * std::log(rate) / (ln2 * ln2));
+   counters.assign(static_cast<std::size_t>(std::fmax(counterCount, 64.0)), 0);
+   hashCount = static_cast<int>(std::lround(counters.size() / static_cast<double>(this->capacity) * ln2));
+   if (hashCount < 1)
+      hashCount = 1;
+} // end constructor
+
+template<class ItemType>
+void CountingBloomFilter<ItemType>::add(const ItemType& item)
+{
+   std::uint64_t first, second;
+   hashPair(item, first, second);
+   for (int i = 0; i < hashCount; i++)
+   {
+      std::uint8_t& counter = counters[(first + i * second) % counters.size()];
+      if (counter != UINT8_MAX)
+         counter++;
+   } // end for
+} // end add
+
+template<class ItemType>
+void CountingBloomFilter<ItemType>::remove(const ItemType& item)
+{
+   std::uint64_t first, second;
+   hashPair(item, first, second);
+   for (int i = 0; i < hashCount; i++)
+   {
+      std::uint8_t& counter = counters[(first + i * second) % counters.size()];
+      if (counter != 0 && counter != UINT8_MAX)
+         counter--;
+   } // end for
+} // end remove
+
+template<class ItemType>
+bool CountingBloomFilter<ItemType>::mightContain(const ItemType& item) const
+{
+   std::uint64_t first, second;
+   hashPair(item, first, second);
+   for (int i = 0; i < hashCount; i++)
+   {
+      if (counters[(first + i * second) % counters.size()] == 0)
+         return false;
+   } // end for
+   return true;
+} // end mightContain
+
+template<class ItemType>
+void CountingBloomFilter<ItemType>::clear()
+{
+   std::fill(counters.begin(), counters.end(), 0);
+} // end clear
+
+template<class ItemType>
+std::size_t CountingBloomFilter<ItemType>::getCapacity() const
+{
+   return capacity;
+} // end getCapacity
+
+template<class ItemType>
+double CountingBloomFilter<ItemType>::getTargetRate() const
+{
+   return targetRate;
+} // end getTargetRate
+
+template<class ItemType>
+std::size_t CountingBloomFilter<ItemType>::getCounterCount() const
+{
+   return counters.size();
+} // end getCounterCount
+
+template<class ItemType>
+int CountingBloomFilter<ItemType>::getHashCount() const
+{
+   return hashCount;
+} // end getHashCount
+
+template<class ItemType>
+double CountingBloomFilter<ItemType>::expectedRate(std::size_t itemCount) const
+{
+   // (1 - e^(-kn/m))^k
+   double unset = std::exp(-static_cast<double>(hashCount) * itemCount / counters.size());
+   return std::pow(1.0 - unset, hashCount);
+} // end expectedRate
+
+// private
+template<class ItemType>
+void CountingBloomFilter<ItemType>::hashPair(const ItemType& item, std::uint64_t& first,
+                                             std::uint64_t& second) const
+{
+   // std::hash may be the identity (integers, pointers); mix it first (SplitMix64)
+   std::uint64_t z = static_cast<std::uint64_t>(std::hash<ItemType>()(item)) + 0x9E3779B97F4A7C15ull;
+   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+   z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+   z ^= z >> 31;
+   first = z >> 32;
+   second = (z & 0xFFFFFFFFull) | 1;  // Never zero, so the probes do not all coincide
+} // end hashPair
+
+#endif
@@ -6,21 +6,29 @@
 
 #include "LinkedBag.h"
 #include "Node.h"
+#include "../Trace.h"
 #include <cstddef>
+#include <unordered_map>
+#include <utility>
 
 
 
 // Assignment 2 functions -------------------------------------------
 template<class ItemType>
 bool LinkedBag<ItemType>::appendK(const ItemType& newEntry, const int& k) {
+    TRACE_SCOPE("LinkedBag::appendK");
     // Create a new node to store the entry
     Node<ItemType>* newNodePtr = new Node<ItemType>(newEntry);
     
     // Case 1: Empty bag or k <= 1 (add to beginning)
     if (isEmpty() || k <= 1) {
         newNodePtr->setNext(headPtr);  // New node points to chain
+        if (headPtr != nullptr) {
+            headPtr->setPrev(newNodePtr);
+        }
         headPtr = newNodePtr;          // New node is now first node
         itemCount++;
+        filterAdd(newEntry);
         return true;
     }
     
@@ -36,14 +44,20 @@ bool LinkedBag<ItemType>::appendK(const ItemType& newEntry, const int& k) {
     
     // Insert the new node
     newNodePtr->setNext(curPtr->getNext());
+    newNodePtr->setPrev(curPtr);
+    if (curPtr->getNext() != nullptr) {
+        curPtr->getNext()->setPrev(newNodePtr);
+    }
     curPtr->setNext(newNodePtr);
     itemCount++;
+    filterAdd(newEntry);
     
     return true;
 }
 
 template<class ItemType>
 Node<ItemType>* LinkedBag<ItemType>::findKthItem(const int& k) const {
+    TRACE_SCOPE("LinkedBag::findKthItem");
     // Invalid input: empty bag or k <= 0 or k > itemCount
     if (isEmpty() || k <= 0 || k > itemCount) {
         return nullptr;
@@ -66,10 +80,10 @@ Node<ItemType>* LinkedBag<ItemType>::findKthItem(const int& k) const {
 // ------------------------------------------------------------------
 
 template<class ItemType>
-LinkedBag<ItemType>::LinkedBag() : headPtr(nullptr), itemCount(0){}  // end default constructor
+LinkedBag<ItemType>::LinkedBag() : headPtr(nullptr), itemCount(0), filterPtr(nullptr){}  // end default constructor
 
 template<class ItemType>
-LinkedBag<ItemType>::LinkedBag(const LinkedBag<ItemType>& aBag){
+LinkedBag<ItemType>::LinkedBag(const LinkedBag<ItemType>& aBag) : filterPtr(nullptr){
 	itemCount = aBag.itemCount;
 	Node<ItemType>* origChainPtr = aBag.headPtr;  // Points to nodes in original chain
 	
@@ -93,6 +107,7 @@ LinkedBag<ItemType>::LinkedBag(const LinkedBag<ItemType>& aBag){
 			
 			// Link new node to end of new chain
 			newChainPtr->setNext(newNodePtr);
+			newNodePtr->setPrev(newChainPtr);
 			
 			// Advance pointer to new last node
 			newChainPtr = newChainPtr->getNext();
@@ -103,11 +118,32 @@ LinkedBag<ItemType>::LinkedBag(const LinkedBag<ItemType>& aBag){
 		
 		newChainPtr->setNext(nullptr);				  // Flag end of chain
 	}  // end if
+	
+	// The copy gets a filter of the same kind, with fresh counts
+	if (aBag.filterPtr != nullptr)
+		rebuildFilter(aBag.filterPtr->filter.getCapacity(), aBag.filterPtr->filter.getTargetRate());
 }  // end copy constructor
 
+template<class ItemType>
+LinkedBag<ItemType>& LinkedBag<ItemType>::operator=(const LinkedBag<ItemType>& aBag){
+	if (this != &aBag){
+		// Build the copy first, then take over its chain
+		LinkedBag<ItemType> copy(aBag);
+		clear();
+		headPtr = copy.headPtr;
+		itemCount = copy.itemCount;
+		std::swap(filterPtr, copy.filterPtr);
+		copy.headPtr = nullptr;
+		copy.itemCount = 0;
+	}  // end if
+	
+	return *this;
+}  // end operator=
+
 template<class ItemType>
 LinkedBag<ItemType>::~LinkedBag(){
 	clear();
+	delete filterPtr;
 }  // end destructor
 
 
@@ -123,54 +159,92 @@ int LinkedBag<ItemType>::getCurrentSize() const{
 
 template<class ItemType>
 bool LinkedBag<ItemType>::add(const ItemType& newEntry){
+	TRACE_SCOPE("LinkedBag::add");
 	// Add to beginning of chain: new node references rest of chain;
 	// (headPtr is null if chain is empty)		  
 	Node<ItemType>* nextNodePtr = new Node<ItemType>();
 	nextNodePtr->setItem(newEntry);
 	nextNodePtr->setNext(headPtr);  // New node points to chain
+	if (headPtr != nullptr)
+		headPtr->setPrev(nextNodePtr);
 	headPtr = nextNodePtr;			// New node is now first node
 	itemCount++;
+	filterAdd(newEntry);
 	
 	return true;
 }  // end add
 
 template<class ItemType>
 std::vector<ItemType> LinkedBag<ItemType>::toVector() const{
+	TRACE_SCOPE("LinkedBag::toVector");
 	std::vector<ItemType> bagContents;
 	Node<ItemType>* curPtr = headPtr;
 	int counter = 0;
-	while ((curPtr != nullptr) && (counter < itemCount)){
-		bagContents.push_back(curPtr->getItem());
-		curPtr = curPtr->getNext();
-		counter++;
-	}  // end while
+	if constexpr (BagItemTraits<ItemType>::trivial){
+		// Size the buffer once and store straight into it
+		bagContents.resize(itemCount);
+		while ((curPtr != nullptr) && (counter < itemCount)){
+			bagContents[counter] = curPtr->getItem();
+			curPtr = curPtr->getNext();
+			counter++;
+		}  // end while
+		bagContents.resize(counter);
+	}
+	else{
+		bagContents.reserve(itemCount);
+		while ((curPtr != nullptr) && (counter < itemCount)){
+			bagContents.push_back(curPtr->getItem());
+			curPtr = curPtr->getNext();
+			counter++;
+		}  // end while
+	}  // end if
 	
 	return bagContents;
 }  // end toVector
 
 template<class ItemType>
 bool LinkedBag<ItemType>::remove(const ItemType& anEntry){
+	TRACE_SCOPE("LinkedBag::remove");
+	if (filterRulesOut(anEntry))
+		return false;
 	Node<ItemType>* entryNodePtr = getPointerTo(anEntry);
+	if (entryNodePtr == nullptr)
+		filterNoteMiss();
 	bool canRemoveItem = !isEmpty() && (entryNodePtr != nullptr);
 	if (canRemoveItem){
-		// Copy data from first node to located node
-		entryNodePtr->setItem(headPtr->getItem());
-		
-		// Delete first node
-		Node<ItemType>* nodeToDeletePtr = headPtr;
-		headPtr = headPtr->getNext();
-		
-		// Return node to the system
-		nodeToDeletePtr->setNext(nullptr);
-		delete nodeToDeletePtr;
-		nodeToDeletePtr = nullptr;
-		
-		itemCount--;
+		// Unlink the located node in place so the remaining order is kept
+		removeNode(entryNodePtr);
 	} // end if
 	
 	return canRemoveItem;
 }  // end remove
 
+template<class ItemType>
+bool LinkedBag<ItemType>::removeNode(Node<ItemType>* nodePtr){
+	TRACE_SCOPE("LinkedBag::removeNode");
+	if (nodePtr == nullptr || isEmpty())
+		return false;
+	
+	// Bridge the neighbours over the node; no traversal is needed
+	Node<ItemType>* prevPtr = nodePtr->getPrev();
+	Node<ItemType>* nextPtr = nodePtr->getNext();
+	if (prevPtr != nullptr)
+		prevPtr->setNext(nextPtr);
+	else
+		headPtr = nextPtr;
+	if (nextPtr != nullptr)
+		nextPtr->setPrev(prevPtr);
+	filterRemove(nodePtr->getItem());
+	
+	// Return node to the system
+	nodePtr->setNext(nullptr);
+	nodePtr->setPrev(nullptr);
+	delete nodePtr;
+	
+	itemCount--;
+	return true;
+}  // end removeNode
+
 template<class ItemType>
 void LinkedBag<ItemType>::clear(){
 	Node<ItemType>* nodeToDeletePtr = headPtr;
@@ -186,10 +260,15 @@ void LinkedBag<ItemType>::clear(){
 	// headPtr is nullptr; nodeToDeletePtr is nullptr
 	
 	itemCount = 0;
+	if (filterPtr != nullptr)
+		filterPtr->filter.clear();
 }  // end clear
 
 template<class ItemType>
 int LinkedBag<ItemType>::getFrequencyOf(const ItemType& anEntry) const{
+	TRACE_SCOPE("LinkedBag::getFrequencyOf");
+	if (filterRulesOut(anEntry))
+		return 0;
 	int frequency = 0;
 	int counter = 0;
 	Node<ItemType>* curPtr = headPtr;
@@ -202,15 +281,296 @@ int LinkedBag<ItemType>::getFrequencyOf(const ItemType& anEntry) const{
 		curPtr = curPtr->getNext();
 	} // end while
 	
+	if (frequency == 0)
+		filterNoteMiss();
 	return frequency;
 }  // end getFrequencyOf
 
 template<class ItemType>
 bool LinkedBag<ItemType>::contains(const ItemType& anEntry) const{
-	return (getPointerTo(anEntry) != nullptr);
+	TRACE_SCOPE("LinkedBag::contains");
+	if (filterRulesOut(anEntry))
+		return false;
+	bool found = (getPointerTo(anEntry) != nullptr);
+	if (!found)
+		filterNoteMiss();
+	return found;
 }  // end contains
 
+template<class ItemType>
+bool LinkedBag<ItemType>::enableMembershipFilter(double falsePositiveRate, int expectedItems){
+	if (!IsBagHashable<ItemType>::value || !(falsePositiveRate > 0.0 && falsePositiveRate < 1.0))
+		return false;
+	std::size_t capacity = static_cast<std::size_t>(expectedItems > itemCount ? expectedItems : itemCount);
+	rebuildFilter(capacity, falsePositiveRate);
+	return true;
+}  // end enableMembershipFilter
+
+template<class ItemType>
+void LinkedBag<ItemType>::disableMembershipFilter(){
+	delete filterPtr;
+	filterPtr = nullptr;
+}  // end disableMembershipFilter
+
+template<class ItemType>
+bool LinkedBag<ItemType>::hasMembershipFilter() const{
+	return filterPtr != nullptr;
+}  // end hasMembershipFilter
+
+template<class ItemType>
+BagFilterStats LinkedBag<ItemType>::getMembershipFilterStats() const{
+	BagFilterStats stats = {0.0, 0.0, 0.0, 0, 0, 0, 0, 0};
+	if (filterPtr == nullptr)
+		return stats;
+	const CountingBloomFilter<ItemType>& filter = filterPtr->filter;
+	long absent = filterPtr->definiteMisses + filterPtr->falsePositives;
+	stats.targetRate = filter.getTargetRate();
+	stats.expectedRate = filter.expectedRate(static_cast<std::size_t>(itemCount));
+	stats.observedRate = (absent > 0) ? static_cast<double>(filterPtr->falsePositives) / absent : 0.0;
+	stats.lookups = filterPtr->lookups;
+	stats.definiteMisses = filterPtr->definiteMisses;
+	stats.falsePositives = filterPtr->falsePositives;
+	stats.counterBytes = filter.getCounterCount();
+	stats.hashCount = filter.getHashCount();
+	return stats;
+}  // end getMembershipFilterStats
+
+
+
+template<class ItemType>
+template<class Compare>
+void LinkedBag<ItemType>::sort(Compare lessThan){
+	TRACE_SCOPE("LinkedBag::sort");
+	if (itemCount < 2)
+		return;
+	
+	// Bottom-up: merge runs of width 1, 2, 4, ... until one run remains
+	for (int width = 1; width < itemCount; width *= 2){
+		Node<ItemType>* remaining = headPtr;
+		Node<ItemType>* newHead = nullptr;
+		Node<ItemType>* newTail = nullptr;
+		
+		while (remaining != nullptr){
+			// Cut off two runs of up to width nodes each
+			Node<ItemType>* left = remaining;
+			Node<ItemType>* right = splitAfter(left, width);
+			remaining = splitAfter(right, width);
+			
+			// Merge them; ties take the left run first to keep the sort stable
+			while (left != nullptr || right != nullptr){
+				Node<ItemType>* next;
+				if (right == nullptr || (left != nullptr && !lessThan(right->getItem(), left->getItem()))){
+					next = left;
+					left = left->getNext();
+				}
+				else{
+					next = right;
+					right = right->getNext();
+				}
+				
+				if (newTail == nullptr)
+					newHead = next;
+				else
+					newTail->setNext(next);
+				newTail = next;
+			}  // end while
+		}  // end while
+		
+		newTail->setNext(nullptr);
+		headPtr = newHead;
+	}  // end for
+	
+	// Merging only maintained next links; restore the back links in one pass
+	Node<ItemType>* prevPtr = nullptr;
+	for (Node<ItemType>* curPtr = headPtr; curPtr != nullptr; curPtr = curPtr->getNext()){
+		curPtr->setPrev(prevPtr);
+		prevPtr = curPtr;
+	}  // end for
+}  // end sort
+
+template<class ItemType>
+LinkedBag<ItemType> LinkedBag<ItemType>::unionWith(const BagInterface<ItemType>& anotherBag) const{
+	TRACE_SCOPE("LinkedBag::unionWith");
+	std::vector<ItemType> mine = toVector();
+	std::vector<ItemType> theirs = anotherBag.toVector();
+	std::vector<bool> alreadyHave = matchEntries(theirs, mine);
+	
+	// Everything here, plus the entries of anotherBag this bag cannot cover
+	LinkedBag<ItemType> result;
+	Node<ItemType>* tailPtr = nullptr;
+	for (const ItemType& entry : mine)
+		result.appendAfter(tailPtr, entry);
+	for (size_t i = 0; i < theirs.size(); i++){
+		if (!alreadyHave[i])
+			result.appendAfter(tailPtr, theirs[i]);
+	}  // end for
+	
+	return result;
+}  // end unionWith
+
+template<class ItemType>
+LinkedBag<ItemType> LinkedBag<ItemType>::intersection(const BagInterface<ItemType>& anotherBag) const{
+	TRACE_SCOPE("LinkedBag::intersection");
+	std::vector<ItemType> mine = toVector();
+	std::vector<bool> shared = matchEntries(mine, anotherBag.toVector());
+	
+	LinkedBag<ItemType> result;
+	Node<ItemType>* tailPtr = nullptr;
+	for (size_t i = 0; i < mine.size(); i++){
+		if (shared[i])
+			result.appendAfter(tailPtr, mine[i]);
+	}  // end for
+	
+	return result;
+}  // end intersection
+
+template<class ItemType>
+LinkedBag<ItemType> LinkedBag<ItemType>::difference(const BagInterface<ItemType>& anotherBag) const{
+	TRACE_SCOPE("LinkedBag::difference");
+	std::vector<ItemType> mine = toVector();
+	std::vector<bool> shared = matchEntries(mine, anotherBag.toVector());
+	
+	LinkedBag<ItemType> result;
+	Node<ItemType>* tailPtr = nullptr;
+	for (size_t i = 0; i < mine.size(); i++){
+		if (!shared[i])
+			result.appendAfter(tailPtr, mine[i]);
+	}  // end for
+	
+	return result;
+}  // end difference
+
+// private
+template<class ItemType>
+std::vector<bool> LinkedBag<ItemType>::matchEntries(const std::vector<ItemType>& from,
+                                                    const std::vector<ItemType>& against){
+	std::vector<bool> matched(from.size(), false);
+	long pairs = static_cast<long>(from.size()) * static_cast<long>(against.size());
+	
+	if constexpr (IsBagHashable<ItemType>::value){
+		if (pairs > SMALL_SET_OP_PAIRS){
+			// Count what against offers, then let each entry of from claim one
+			std::unordered_map<ItemType, int> available;
+			available.reserve(against.size());
+			for (const ItemType& entry : against)
+				available[entry]++;
+			for (size_t i = 0; i < from.size(); i++){
+				typename std::unordered_map<ItemType, int>::iterator found = available.find(from[i]);
+				if (found != available.end() && found->second > 0){
+					found->second--;
+					matched[i] = true;
+				}  // end if
+			}  // end for
+			return matched;
+		}  // end if
+	}  // end if
+	
+	// Small bags (or unhashable items): pair entries directly
+	std::vector<bool> used(against.size(), false);
+	for (size_t i = 0; i < from.size(); i++){
+		for (size_t j = 0; j < against.size(); j++){
+			if (!used[j] && from[i] == against[j]){
+				used[j] = true;
+				matched[i] = true;
+				break;
+			}  // end if
+		}  // end for
+	}  // end for
+	return matched;
+}  // end matchEntries
+
+// private
+template<class ItemType>
+void LinkedBag<ItemType>::appendAfter(Node<ItemType>*& tailPtr, const ItemType& newEntry){
+	Node<ItemType>* newNodePtr = new Node<ItemType>(newEntry);
+	newNodePtr->setPrev(tailPtr);
+	if (tailPtr == nullptr)
+		headPtr = newNodePtr;
+	else
+		tailPtr->setNext(newNodePtr);
+	tailPtr = newNodePtr;
+	itemCount++;
+	filterAdd(newEntry);
+}  // end appendAfter
+
+// private
+template<class ItemType>
+void LinkedBag<ItemType>::filterAdd(const ItemType& newEntry){
+	if constexpr (IsBagHashable<ItemType>::value){
+		if (filterPtr == nullptr)
+			return;
+		// Past capacity the false-positive rate climbs; double the filter instead
+		if (static_cast<std::size_t>(itemCount) > filterPtr->filter.getCapacity())
+			rebuildFilter(2 * static_cast<std::size_t>(itemCount), filterPtr->filter.getTargetRate());
+		else
+			filterPtr->filter.add(newEntry);
+	}  // end if
+}  // end filterAdd
+
+// private
+template<class ItemType>
+void LinkedBag<ItemType>::filterRemove(const ItemType& anEntry){
+	if constexpr (IsBagHashable<ItemType>::value){
+		if (filterPtr != nullptr)
+			filterPtr->filter.remove(anEntry);
+	}  // end if
+}  // end filterRemove
 
+// private
+template<class ItemType>
+void LinkedBag<ItemType>::rebuildFilter(std::size_t capacity, double falsePositiveRate){
+	if constexpr (IsBagHashable<ItemType>::value){
+		MembershipFilter* rebuilt = new MembershipFilter{CountingBloomFilter<ItemType>(capacity, falsePositiveRate),
+		                                                 0, 0, 0};
+		if (filterPtr != nullptr){
+			// Growing keeps the lookup counts
+			rebuilt->lookups = filterPtr->lookups;
+			rebuilt->definiteMisses = filterPtr->definiteMisses;
+			rebuilt->falsePositives = filterPtr->falsePositives;
+			delete filterPtr;
+		}  // end if
+		filterPtr = rebuilt;
+		for (Node<ItemType>* curPtr = headPtr; curPtr != nullptr; curPtr = curPtr->getNext())
+			filterPtr->filter.add(curPtr->getItem());
+	}  // end if
+}  // end rebuildFilter
+
+// private
+template<class ItemType>
+bool LinkedBag<ItemType>::filterRulesOut(const ItemType& anEntry) const{
+	if constexpr (IsBagHashable<ItemType>::value){
+		if (filterPtr == nullptr)
+			return false;
+		filterPtr->lookups++;
+		if (!filterPtr->filter.mightContain(anEntry)){
+			filterPtr->definiteMisses++;
+			return true;
+		}  // end if
+	}  // end if
+	return false;
+}  // end filterRulesOut
+
+// private
+template<class ItemType>
+void LinkedBag<ItemType>::filterNoteMiss() const{
+	if (filterPtr != nullptr)
+		filterPtr->falsePositives++;
+}  // end filterNoteMiss
+
+// private
+// Detaches the chain after the first count nodes starting at start and
+// returns the detached remainder (nullptr if there is none).
+template<class ItemType>
+Node<ItemType>* LinkedBag<ItemType>::splitAfter(Node<ItemType>* start, int count){
+	for (int i = 1; start != nullptr && i < count; i++)
+		start = start->getNext();
+	if (start == nullptr)
+		return nullptr;
+	
+	Node<ItemType>* rest = start->getNext();
+	start->setNext(nullptr);
+	return rest;
+}  // end splitAfter
 
 // private
 // Returns either a pointer to the node containing a given entry 
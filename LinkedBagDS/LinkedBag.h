@@ -8,7 +8,33 @@
 #define LINKED_BAG_
 
 #include "BagInterface.h"
+#include "CountingBloomFilter.h"
 #include "Node.h"
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// True when std::hash<T> can hash T, so set operations can use a hash table
+template<class T, class = void>
+struct IsBagHashable : std::false_type {};
+
+template<class T>
+struct IsBagHashable<T, std::void_t<decltype(std::hash<T>()(std::declval<const T&>()))> >
+   : std::true_type {};
+
+// What a bag's membership filter has done since it was enabled
+struct BagFilterStats
+{
+   double targetRate;         // False-positive rate the filter was sized for
+   double expectedRate;       // False-positive rate predicted at the current size
+   double observedRate;       // falsePositives / lookups of absent entries
+   long lookups;              // contains/remove/getFrequencyOf calls checked
+   long definiteMisses;       // Answered by the filter without walking the chain
+   long falsePositives;       // Passed the filter, then not found in the chain
+   std::size_t counterBytes;  // Memory held by the filter's counters
+   int hashCount;             // Counters touched per entry
+}; // end BagFilterStats
 
 template<class ItemType>
 class LinkedBag : public BagInterface<ItemType>
@@ -22,9 +48,45 @@ private:
 	// Node<ItemType>* getPointerTo(const ItemType& target) const;
 	Node<ItemType>* getPointerTo(const ItemType& target) const;
 	
+	// Cuts the chain after count nodes from start; returns the remainder.
+	static Node<ItemType>* splitAfter(Node<ItemType>* start, int count);
+	
+	// Below this many item pairs the set operations compare directly
+	// instead of building a hash table.
+	static const long SMALL_SET_OP_PAIRS = 256;
+	
+	// Marks each entry of from that can be paired with a distinct equal
+	// entry of against (earlier entries are paired first).
+	static std::vector<bool> matchEntries(const std::vector<ItemType>& from,
+	                                      const std::vector<ItemType>& against);
+	
+	// Appends newEntry after tailPtr (or as the head when tailPtr is null).
+	void appendAfter(Node<ItemType>*& tailPtr, const ItemType& newEntry);
+	
+	// Optional counting Bloom filter over the entries, plus its counters
+	struct MembershipFilter
+	{
+		CountingBloomFilter<ItemType> filter;
+		long lookups;
+		long definiteMisses;
+		long falsePositives;
+	}; // end MembershipFilter
+	MembershipFilter* filterPtr; // nullptr unless enabled
+	
+	// Keep the filter in step with the chain (no-ops without a filter).
+	void filterAdd(const ItemType& newEntry);
+	void filterRemove(const ItemType& anEntry);
+	// Rebuilds the filter from the chain, sized for capacity entries.
+	void rebuildFilter(std::size_t capacity, double falsePositiveRate);
+	// True if the filter proves anEntry absent; counts the lookup.
+	bool filterRulesOut(const ItemType& anEntry) const;
+	// Records that an entry that passed the filter was not in the chain.
+	void filterNoteMiss() const;
+	
 public:
 	LinkedBag();
 	LinkedBag(const LinkedBag<ItemType>& aBag); // Copy constructor
+	LinkedBag<ItemType>& operator=(const LinkedBag<ItemType>& aBag); // Deep-copy assignment
 	virtual ~LinkedBag();						// Destructor should be virtual
 
 	// Assignment 2 functions -------------------------------------------
@@ -36,11 +98,44 @@ public:
 	bool isEmpty() const;
 	bool add(const ItemType& newEntry);
 	bool remove(const ItemType& anEntry);
+	
+	// Unlinks and frees a node of this bag in O(1), keeping the order of
+	// the other entries. nodePtr must come from this bag (e.g. findKthItem).
+	bool removeNode(Node<ItemType>* nodePtr);
 	void clear();
 	bool contains(const ItemType& anEntry) const;
 	int getFrequencyOf(const ItemType& anEntry) const;
 	std::vector<ItemType> toVector() const;
-
+	
+	// Multiset operations. Each counts an entry as many times as it occurs and
+	// runs in expected O(n + m) using a temporary hash table (a direct
+	// comparison for small bags or items std::hash cannot hash).
+	// Entries keep this bag's order, followed by anotherBag's for unionWith.
+	
+	// Entries of either bag, each as many times as in the bag holding more.
+	LinkedBag<ItemType> unionWith(const BagInterface<ItemType>& anotherBag) const;
+	// Entries of both bags, each as many times as in the bag holding fewer.
+	LinkedBag<ItemType> intersection(const BagInterface<ItemType>& anotherBag) const;
+	// Entries of this bag left after removing one per entry of anotherBag.
+	LinkedBag<ItemType> difference(const BagInterface<ItemType>& anotherBag) const;
+	
+	// Stable, in-place merge sort in O(n log n). Nodes are relinked, never
+	// allocated or copied. lessThan(a, b) returns true if a belongs before b.
+	template<class Compare>
+	void sort(Compare lessThan);
+	
+	// Attaches a counting Bloom filter so contains(), remove() and
+	// getFrequencyOf() answer most misses in O(1) instead of walking the
+	// chain; possible hits still walk it. The filter is sized for
+	// expectedItems entries (at least the current size) and doubles
+	// whenever the bag outgrows it. Returns false if falsePositiveRate is
+	// not in (0, 1) or std::hash cannot hash the item type. Entries changed
+	// through Node::setItem() bypass the filter and must not be.
+	bool enableMembershipFilter(double falsePositiveRate, int expectedItems = 0);
+	void disableMembershipFilter();
+	bool hasMembershipFilter() const;
+	// Sizes, rates and lookup counts of the filter (all zero without one).
+	BagFilterStats getMembershipFilterStats() const;
 
 
 }; // end LinkedBag
@@ -7,18 +7,18 @@
 //#include <cstddef>
 
 template<class ItemType>
-Node<ItemType>::Node() : next(nullptr)
+Node<ItemType>::Node() : next(nullptr), prev(nullptr)
 {
 } // end default constructor
 
 template<class ItemType>
-Node<ItemType>::Node(const ItemType& anItem) : item(anItem), next(nullptr)
+Node<ItemType>::Node(const ItemType& anItem) : item(anItem), next(nullptr), prev(nullptr)
 {
 } // end constructor
 
 template<class ItemType>
 Node<ItemType>::Node(const ItemType& anItem, Node<ItemType>* nextNodePtr) :
-                item(anItem), next(nextNodePtr)
+                item(anItem), next(nextNodePtr), prev(nullptr)
 {
 } // end constructor
 
@@ -35,7 +35,13 @@ void Node<ItemType>::setNext(Node<ItemType>* nextNodePtr)
 } // end setNext
 
 template<class ItemType>
-ItemType Node<ItemType>::getItem() const
+void Node<ItemType>::setPrev(Node<ItemType>* prevNodePtr)
+{
+   prev = prevNodePtr;
+} // end setPrev
+
+template<class ItemType>
+typename BagItemTraits<ItemType>::ItemRef Node<ItemType>::getItem() const
 {
    return item;
 } // end getItem
@@ -45,3 +51,34 @@ Node<ItemType>* Node<ItemType>::getNext() const
 {
    return next;
 } // end getNext
+
+template<class ItemType>
+Node<ItemType>* Node<ItemType>::getPrev() const
+{
+   return prev;
+} // end getPrev
+
+template<class ItemType>
+void* Node<ItemType>::operator new(std::size_t size)
+{
+   if constexpr (BagItemTraits<ItemType>::trivial && alignof(Node<ItemType>) <= alignof(std::max_align_t))
+   {
+      if (size == sizeof(Node<ItemType>))
+         return NodePool<sizeof(Node<ItemType>), alignof(Node<ItemType>)>::allocate();
+   } // end if
+   return ::operator new(size);
+} // end operator new
+
+template<class ItemType>
+void Node<ItemType>::operator delete(void* nodePtr, std::size_t size)
+{
+   if constexpr (BagItemTraits<ItemType>::trivial && alignof(Node<ItemType>) <= alignof(std::max_align_t))
+   {
+      if (size == sizeof(Node<ItemType>))
+      {
+         NodePool<sizeof(Node<ItemType>), alignof(Node<ItemType>)>::release(nodePtr);
+         return;
+      } // end if
+   } // end if
+   ::operator delete(nodePtr);
+} // end operator delete
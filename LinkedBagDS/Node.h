@@ -6,12 +6,30 @@
 #ifndef NODE_
 #define NODE_
 
+#include <cstddef>
+#include <type_traits>
+#include "NodePool.h"
+
+// Compile-time choices for how a node stores and hands out its item
+template<class ItemType>
+struct BagItemTraits
+{
+   // memcpy-able items (pointers, numbers, plain structs): nodes come
+   // from a NodePool and items can be copied in bulk
+   static const bool trivial = std::is_trivially_copyable<ItemType>::value;
+   
+   // Small trivial items are returned by value, everything else by reference
+   typedef typename std::conditional<trivial && sizeof(ItemType) <= 2 * sizeof(void*),
+                                     ItemType, const ItemType&>::type ItemRef;
+}; // end BagItemTraits
+
 template<class ItemType>
 class Node
 {
 private:
    ItemType        item; // A data item
    Node<ItemType>* next; // Pointer to next node
+   Node<ItemType>* prev; // Pointer to previous node (nullptr at the head)
    
 public:
    Node();
@@ -19,8 +37,14 @@ public:
    Node(const ItemType& anItem, Node<ItemType>* nextNodePtr);
    void setItem(const ItemType& anItem);
    void setNext(Node<ItemType>* nextNodePtr);
-   ItemType getItem() const ;
+   void setPrev(Node<ItemType>* prevNodePtr);
+   typename BagItemTraits<ItemType>::ItemRef getItem() const ;
    Node<ItemType>* getNext() const ;
+   Node<ItemType>* getPrev() const ;
+   
+   // Nodes of trivially copyable items are carved from a shared pool
+   static void* operator new(std::size_t size);
+   static void operator delete(void* nodePtr, std::size_t size);
 }; // end Node
 
 #include "Node.cpp"
@@ -0,0 +1,133 @@
+/** Fixed-size free-list allocator for bag nodes.
+	 @file NodePool.h */
+#ifndef NODE_POOL_
+#define NODE_POOL_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+// Hands out blocks of NodeSize bytes, aligned to NodeAlign, carved from larger slabs. Each thread
+// keeps its own free list, so allocate/release take no lock; a thread
+// that runs dry takes every block other threads have given back, or carves
+// a new slab. Slabs are kept for the life of the process and reused, so
+// blocks carry no per-allocation header. NodeAlign must not exceed
+// alignof(std::max_align_t).
+template<std::size_t NodeSize, std::size_t NodeAlign>
+class NodePool
+{
+public:
+   static void* allocate();
+   static void release(void* block);
+   
+private:
+   struct FreeBlock
+   {
+      FreeBlock* next;
+   }; // end FreeBlock
+   
+   // A thread's free list; whatever is left when the thread ends is
+   // handed to the shared list for other threads to use
+   struct LocalList
+   {
+      FreeBlock* head = nullptr;
+      ~LocalList();
+   }; // end LocalList
+   
+   static_assert(NodeAlign <= alignof(std::max_align_t), "NodePool cannot over-align blocks");
+   
+   static const std::size_t BLOCK_ALIGN = NodeAlign < alignof(FreeBlock) ? alignof(FreeBlock) : NodeAlign;
+   static const std::size_t BLOCK_SIZE =
+      ((NodeSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : NodeSize) + BLOCK_ALIGN - 1)
+      / BLOCK_ALIGN * BLOCK_ALIGN;
+   static const std::size_t BLOCKS_PER_SLAB = 256;
+   
+   static LocalList& localList();
+   static std::mutex& sharedLock();
+   static FreeBlock*& sharedHead();
+   static FreeBlock* refill();
+}; // end NodePool
+
+template<std::size_t NodeSize, std::size_t NodeAlign>
+void* NodePool<NodeSize, NodeAlign>::allocate()
+{
+   LocalList& list = localList();
+   if (list.head == nullptr)
+      list.head = refill();
+   FreeBlock* block = list.head;
+   list.head = block->next;
+   return block;
+} // end allocate
+
+template<std::size_t NodeSize, std::size_t NodeAlign>
+void NodePool<NodeSize, NodeAlign>::release(void* block)
+{
+   if (block == nullptr)
+      return;
+   LocalList& list = localList();
+   FreeBlock* freed = static_cast<FreeBlock*>(block);
+   freed->next = list.head;
+   list.head = freed;
+} // end release
+
+template<std::size_t NodeSize, std::size_t NodeAlign>
+NodePool<NodeSize, NodeAlign>::LocalList::~LocalList()
+{
+   if (head == nullptr)
+      return;
+   FreeBlock* tail = head;
+   while (tail->next != nullptr)
+      tail = tail->next;
+   
+   std::lock_guard<std::mutex> guard(sharedLock());
+   tail->next = sharedHead();
+   sharedHead() = head;
+   head = nullptr;
+} // end destructor
+
+template<std::size_t NodeSize, std::size_t NodeAlign>
+typename NodePool<NodeSize, NodeAlign>::LocalList& NodePool<NodeSize, NodeAlign>::localList()
+{
+   thread_local LocalList list;
+   return list;
+} // end localList
+
+template<std::size_t NodeSize, std::size_t NodeAlign>
+std::mutex& NodePool<NodeSize, NodeAlign>::sharedLock()
+{
+   // Leaked so threads ending during static destruction can still use it
+   static std::mutex* lock = new std::mutex();
+   return *lock;
+} // end sharedLock
+
+template<std::size_t NodeSize, std::size_t NodeAlign>
+typename NodePool<NodeSize, NodeAlign>::FreeBlock*& NodePool<NodeSize, NodeAlign>::sharedHead()
+{
+   static FreeBlock* head = nullptr;
+   return head;
+} // end sharedHead
+
+template<std::size_t NodeSize, std::size_t NodeAlign>
+typename NodePool<NodeSize, NodeAlign>::FreeBlock* NodePool<NodeSize, NodeAlign>::refill()
+{
+   {
+      // Take everything other threads have given back
+      std::lock_guard<std::mutex> guard(sharedLock());
+      FreeBlock* taken = sharedHead();
+      if (taken != nullptr)
+      {
+         sharedHead() = nullptr;
+         return taken;
+      } // end if
+   }
+   
+   // Carve a new slab into a free list
+   char* slab = static_cast<char*>(::operator new(BLOCK_SIZE * BLOCKS_PER_SLAB));
+   for (std::size_t i = 0; i + 1 < BLOCKS_PER_SLAB; i++)
+      reinterpret_cast<FreeBlock*>(slab + i * BLOCK_SIZE)->next =
+         reinterpret_cast<FreeBlock*>(slab + (i + 1) * BLOCK_SIZE);
+   reinterpret_cast<FreeBlock*>(slab + (BLOCKS_PER_SLAB - 1) * BLOCK_SIZE)->next = nullptr;
+   return reinterpret_cast<FreeBlock*>(slab);
+} // end refill
+
+#endif
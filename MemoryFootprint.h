@@ -0,0 +1,58 @@
+#ifndef MEMORY_FOOTPRINT_H
+#define MEMORY_FOOTPRINT_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Bytes attributed to a vendor, split by where they live
+ */
+struct MemoryFootprint {
+    std::size_t nodeOverhead;   ///< LinkedBag nodes plus the product slot map
+    std::size_t objectHeaders;  ///< vtable pointers of the Product objects
+    std::size_t inlineData;     ///< Remaining sizeof() of the Vendor and Product objects
+    std::size_t stringHeap;     ///< Heap buffers owned by std::string fields
+
+    /**
+     * @brief Default constructor
+     * @post Every category is zero
+     */
+    MemoryFootprint() : nodeOverhead(0), objectHeaders(0), inlineData(0), stringHeap(0) {}
+
+    /**
+     * @brief Gets the sum of all categories
+     * @return Total bytes
+     */
+    std::size_t total() const {
+        return nodeOverhead + objectHeaders + inlineData + stringHeap;
+    }
+
+    /**
+     * @brief Prints the categories and the total
+     * @param out The stream to print to
+     */
+    void display(std::ostream& out = std::cout) const {
+        out << "Node overhead:  " << nodeOverhead << " bytes" << std::endl;
+        out << "Object headers: " << objectHeaders << " bytes" << std::endl;
+        out << "Inline data:    " << inlineData << " bytes" << std::endl;
+        out << "String heap:    " << stringHeap << " bytes" << std::endl;
+        out << "Total:          " << total() << " bytes" << std::endl;
+    }
+};
+
+/**
+ * @brief Gets the heap bytes a string owns
+ * @param text The string
+ * @return 0 if the characters sit in the small-string buffer, otherwise capacity + 1
+ */
+inline std::size_t stringHeapBytes(const std::string& text) {
+    const char* data = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    if (data >= object && data < object + sizeof(std::string)) {
+        return 0;
+    }
+    return text.capacity() + 1;
+}
+
+#endif // MEMORY_FOOTPRINT_H
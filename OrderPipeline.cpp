@@ -0,0 +1,152 @@
+#include "OrderPipeline.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+const std::size_t OrderPipeline::LOCK_STRIPES;
+
+// Constructor - start the workers
+OrderPipeline::OrderPipeline(int workerCount, int batchSize, int queueCapacity)
+    : batchSize(std::max(1, batchSize)),
+      capacity(static_cast<std::size_t>(std::max(1, queueCapacity))),
+      closed(false), batchesApplied(0), ordersCompleted(0) {
+    int count = std::max(1, workerCount);
+    for (int i = 0; i < count; i++) {
+        workers.emplace_back(&OrderPipeline::workerLoop, this);
+    }
+}
+
+// Destructor - finish queued orders before returning
+OrderPipeline::~OrderPipeline() {
+    shutdown();
+}
+
+// Order submission
+bool OrderPipeline::submit(Product* product, int quantity, Completion done) {
+    if (product == nullptr) {
+        if (done) {
+            done(false);
+        }
+        return false;
+    }
+
+    std::unique_lock<std::mutex> guard(queueLock);
+    notFull.wait(guard, [this] { return closed || queue.size() < capacity; });
+    if (closed) {
+        guard.unlock();
+        if (done) {
+            done(false);
+        }
+        return false;
+    }
+    queue.push_back(Order{product, quantity, std::move(done)});
+    guard.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+std::future<bool> OrderPipeline::submit(Product* product, int quantity) {
+    std::shared_ptr<std::promise<bool> > result = std::make_shared<std::promise<bool> >();
+    std::future<bool> outcome = result->get_future();
+    submit(product, quantity, [result](bool sold) { result->set_value(sold); });
+    return outcome;
+}
+
+void OrderPipeline::shutdown() {
+    {
+        std::lock_guard<std::mutex> guard(queueLock);
+        closed = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+// Counters
+std::size_t OrderPipeline::getBatchesApplied() const {
+    std::lock_guard<std::mutex> guard(queueLock);
+    return batchesApplied;
+}
+
+std::size_t OrderPipeline::getOrdersCompleted() const {
+    std::lock_guard<std::mutex> guard(queueLock);
+    return ordersCompleted;
+}
+
+// Worker side
+void OrderPipeline::workerLoop() {
+    std::vector<Order> batch;
+    batch.reserve(batchSize);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(queueLock);
+            notEmpty.wait(guard, [this] { return closed || !queue.empty(); });
+            if (queue.empty()) {
+                return; // Closed and fully drained
+            }
+            std::size_t take = std::min(queue.size(), static_cast<std::size_t>(batchSize));
+            for (std::size_t i = 0; i < take; i++) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        notFull.notify_all();
+
+        // Group by product; stable so each product's orders keep arrival order
+        std::stable_sort(batch.begin(), batch.end(), [](const Order& a, const Order& b) {
+            return std::less<Product*>()(a.product, b.product);
+        });
+
+        std::size_t groups = 0;
+        std::size_t first = 0;
+        while (first < batch.size()) {
+            std::size_t last = first + 1;
+            while (last < batch.size() && batch[last].product == batch[first].product) {
+                last++;
+            }
+            applyGroup(batch, first, last);
+            groups++;
+            first = last;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(queueLock);
+            batchesApplied += groups;
+            ordersCompleted += batch.size();
+        }
+        batch.clear();
+    }
+}
+
+void OrderPipeline::applyGroup(std::vector<Order>& orders, std::size_t first, std::size_t last) {
+    Product* product = orders[first].product;
+    std::vector<int> quantities;
+    std::vector<bool> accepted;
+    quantities.reserve(last - first);
+    for (std::size_t i = first; i < last; i++) {
+        quantities.push_back(orders[i].quantity);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lockFor(product));
+        product->sellBatch(quantities, accepted);
+    }
+
+    for (std::size_t i = first; i < last; i++) {
+        if (orders[i].done) {
+            orders[i].done(accepted[i - first]);
+        }
+    }
+}
+
+std::mutex& OrderPipeline::lockFor(const Product* product) {
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(product);
+    // Drop the allocation alignment bits before picking a stripe
+    return productLocks[(address >> 4) % LOCK_STRIPES];
+}
@@ -0,0 +1,137 @@
+#ifndef ORDER_PIPELINE_H
+#define ORDER_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Product.h"
+
+/**
+ * @brief Asynchronous, batched processor for sell orders
+ *
+ * Any number of threads submit sell orders into a bounded queue. Worker
+ * threads drain up to batchSize orders at a time, group them by product
+ * and apply each group with a single Product::sellBatch() call under that
+ * product's lock. Every order's completion callback then runs on the
+ * worker thread with the outcome of that order.
+ *
+ * The product locks belong to the pipeline, so products with orders in
+ * flight must not also be sold through Vendor::sellProduct() concurrently.
+ * Sales made here bypass the owning Vendor, which is not thread-safe: once
+ * the orders have completed, the owner passes each product to
+ * Vendor::publishProduct() so its revenue and snapshots catch up.
+ */
+class OrderPipeline {
+public:
+    /// Called once per order with true if the order was sold
+    typedef std::function<void(bool)> Completion;
+
+    /**
+     * @brief Parameterized constructor
+     * @param workerCount Number of worker threads (at least 1)
+     * @param batchSize Most orders a worker takes from the queue at once (at least 1)
+     * @param queueCapacity Most orders waiting in the queue before submit() blocks
+     * @pre None
+     * @post The workers are running and the pipeline accepts orders
+     */
+    OrderPipeline(int workerCount = 4, int batchSize = 64, int queueCapacity = 4096);
+
+    /**
+     * @brief Destructor
+     * @pre None
+     * @post Queued orders are processed, then the workers are joined
+     */
+    ~OrderPipeline();
+
+    OrderPipeline(const OrderPipeline&) = delete;
+    OrderPipeline& operator=(const OrderPipeline&) = delete;
+
+    /**
+     * @brief Queues a sell order, blocking while the queue is full
+     * @param product The product to sell
+     * @param quantity The quantity to sell
+     * @param done Called on a worker thread with the outcome of the order
+     * @pre product stays alive until done has run
+     * @post The order is queued, or done(false) has run if the pipeline is shut down
+     * @return True if the order was queued, false otherwise
+     */
+    bool submit(Product* product, int quantity, Completion done);
+
+    /**
+     * @brief Queues a sell order and returns a future for its outcome
+     * @param product The product to sell
+     * @param quantity The quantity to sell
+     * @pre product stays alive until the future is ready
+     * @return A future that becomes true if the order was sold, false otherwise
+     */
+    std::future<bool> submit(Product* product, int quantity);
+
+    /**
+     * @brief Stops accepting orders, drains the queue and joins the workers
+     * @pre None
+     * @post Every queued order has completed and no workers are running
+     */
+    void shutdown();
+
+    /**
+     * @brief Gets the number of sellBatch() calls made so far
+     * @return The number of product groups applied
+     */
+    std::size_t getBatchesApplied() const;
+
+    /**
+     * @brief Gets the number of orders completed so far
+     * @return The number of orders whose completion has run
+     */
+    std::size_t getOrdersCompleted() const;
+
+private:
+    /// A queued sell request
+    struct Order {
+        Product* product;
+        int quantity;
+        Completion done;
+    };
+
+    /// Number of product locks; products hash onto them by address
+    static const std::size_t LOCK_STRIPES = 64;
+
+    int batchSize;                       ///< Most orders taken per dequeue
+    std::size_t capacity;                ///< Queue bound
+    std::deque<Order> queue;             ///< Orders waiting for a worker
+    mutable std::mutex queueLock;        ///< Guards queue, closed and the counters
+    std::condition_variable notEmpty;    ///< Signalled when an order is queued or on shutdown
+    std::condition_variable notFull;     ///< Signalled when workers free queue space
+    bool closed;                         ///< True once shutdown() has started
+    std::size_t batchesApplied;          ///< sellBatch() calls so far
+    std::size_t ordersCompleted;         ///< Completions run so far
+    std::mutex productLocks[LOCK_STRIPES]; ///< Serialize sells of the same product across workers
+    std::vector<std::thread> workers;    ///< Worker threads
+
+    /**
+     * @brief Worker loop: dequeue a batch, group by product, apply, complete
+     */
+    void workerLoop();
+
+    /**
+     * @brief Applies one product's orders and runs their completions
+     * @param orders The batch being processed
+     * @param first Index of the group's first order in orders
+     * @param last One past the group's last order
+     */
+    void applyGroup(std::vector<Order>& orders, std::size_t first, std::size_t last);
+
+    /**
+     * @brief Picks the lock that guards a product
+     * @param product The product
+     * @return The stripe for that product
+     */
+    std::mutex& lockFor(const Product* product);
+};
+
+#endif // ORDER_PIPELINE_H
@@ -1,25 +1,62 @@
 #include "Product.h"
+#include "MemoryFootprint.h"
+#include "Stats.h"
+#include <cassert>
 #include <iostream>
 #include <string>
 #include <cstdlib>
 #include <ctime>
 
+namespace {
+
+// Appends everything written to it to a string, keeping the string's capacity
+class StringAppendBuffer : public std::streambuf {
+public:
+    explicit StringAppendBuffer(std::string& text) : text(text) {}
+
+protected:
+    int overflow(int c) override {
+        if (c != traits_type::eof()) {
+            text += static_cast<char>(c);
+        }
+        return c;
+    }
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        text.append(data, static_cast<std::size_t>(count));
+        return count;
+    }
+
+private:
+    std::string& text;
+};
+
+} // namespace
+
 // Product class implementations
+const int Product::PRODUCT_MODIFY_FIELDS;
+
 // Constructors
-Product::Product() : name(""), description(""), rating(0), soldCount(0) {}
+Product::Product() : rating(0), soldCount(0), id(0), price(0), revision(1), renderedRevision(0),
+                     renderBusy(false), name("") {}
 
-Product::Product(const std::string& name, const std::string& description, int rating, int soldCount)
-    : name(name), description(description), rating(rating), soldCount(soldCount) {}
+Product::Product(const std::string& name, const std::string& description, int rating, int soldCount,
+                 Cents price)
+    : rating(rating), soldCount(soldCount), id(0), price(price), revision(1), renderedRevision(0),
+      renderBusy(false), description(description), name(name) {}
 
 // Destructor
 Product::~Product() {}
 
 // Getters
-std::string Product::getName() const {
+std::string_view Product::getName() const {
     return name;
 }
 
-std::string Product::getDescription() const {
+ColdText::View Product::getDescription() const {
+    return description.load();
+}
+
+const ColdText& Product::getDescriptionText() const {
     return description;
 }
 
@@ -31,68 +68,212 @@ int Product::getSoldCount() const {
     return soldCount;
 }
 
+ProductId Product::getId() const {
+    return id;
+}
+
 // Setters
+Cents Product::getPrice() const {
+    return price;
+}
+
+Cents Product::getRevenue() const {
+    return price * soldCount;
+}
+
 void Product::setName(const std::string& name) {
     this->name = name;
+    touch();
 }
 
 void Product::setDescription(const std::string& description) {
-    this->description = description;
+    this->description.assign(description);
+    touch();
 }
 
 void Product::setRating(int rating) {
     this->rating = rating;
+    touch();
 }
 
 void Product::setSoldCount(int soldCount) {
     this->soldCount = soldCount;
+    touch();
+}
+
+void Product::setId(ProductId id) {
+    this->id = id;
+}
+
+void Product::setPrice(Cents price) {
+    this->price = price;
+    touch();
+}
+
+// Render cache
+void Product::touch() {
+    revision.fetch_add(1, std::memory_order_release);
+}
+
+// Price text conversion
+bool Product::parsePrice(const std::string& text, Cents& price) {
+    size_t pos = 0;
+    while (pos < text.size() && text[pos] == ' ') {
+        pos++;
+    }
+    if (pos < text.size() && text[pos] == '$') {
+        pos++;
+    }
+    
+    Cents dollars = 0;
+    Cents cents = 0;
+    int wholeDigits = 0;
+    int fractionDigits = 0;
+    for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; pos++, wholeDigits++) {
+        if (dollars > 1000000000000LL) {
+            return false; // Far beyond any real price; avoid overflow
+        }
+        dollars = dollars * 10 + (text[pos] - '0');
+    }
+    if (pos < text.size() && text[pos] == '.') {
+        for (pos++; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; pos++, fractionDigits++) {
+            if (fractionDigits == 2) {
+                return false; // No fractions of a cent
+            }
+            cents = cents * 10 + (text[pos] - '0');
+        }
+    }
+    while (pos < text.size() && text[pos] == ' ') {
+        pos++;
+    }
+    if (pos != text.size() || wholeDigits + fractionDigits == 0) {
+        return false;
+    }
+    if (fractionDigits == 1) {
+        cents *= 10;
+    }
+    price = dollars * 100 + cents;
+    return true;
+}
+
+std::string Product::formatPrice(Cents amount) {
+    std::string sign = amount < 0 ? "-" : "";
+    Cents magnitude = amount < 0 ? -amount : amount;
+    Cents cents = magnitude % 100;
+    return sign + std::to_string(magnitude / 100) + (cents < 10 ? ".0" : ".") + std::to_string(cents);
 }
 
 // Display product information
 void Product::display() const {
-    std::cout << "Product Name: " << name << std::endl;
-    std::cout << "Description: " << description << std::endl;
-    std::cout << "Rating: " << rating << std::endl;
-    std::cout << "Sold Count: " << soldCount << std::endl;
+    std::uint64_t current = revision.load(std::memory_order_acquire);
+    if (renderBusy.exchange(true, std::memory_order_acquire)) {
+        // Another thread is using the cache; format straight to the console
+        STATS_COUNT(RenderMiss);
+        render(std::cout);
+        return;
+    }
+    ColdText::View text;
+    if (renderedRevision == current && rendered.loadIfResident(text)) {
+        renderBusy.store(false, std::memory_order_release);
+        STATS_COUNT(RenderHit);
+        std::cout.write(text.text().data(), static_cast<std::streamsize>(text.size()));
+        return;
+    }
+    STATS_COUNT(RenderMiss);
+    std::string fresh;
+    StringAppendBuffer buffer(fresh);
+    std::ostream out(&buffer);
+    render(out);
+    std::cout.write(fresh.data(), static_cast<std::streamsize>(fresh.size()));
+    rendered = ColdText::discardable(fresh);
+    renderedRevision = current;
+    renderBusy.store(false, std::memory_order_release);
+}
+
+void Product::render(std::ostream& out) const {
+    out << "Product Name: " << name << std::endl;
+    out << "Description: " << description.load() << std::endl;
+    out << "Rating: " << rating << std::endl;
+    out << "Price: $" << formatPrice(price) << std::endl;
+    out << "Sold Count: " << soldCount << std::endl;
 }
 
 // Modify product details
 bool Product::modify() {
-    std::string newName, newDescription;
-    
-    std::cout << "Current Name: " << name << std::endl;
-    std::cout << "Enter new name (or press Enter to keep current): ";
-    std::getline(std::cin, newName);
-    if (!newName.empty()) {
-        name = newName;
+    for (int field = 0; field < getModifyFieldCount(); field++) {
+        std::string answer;
+        promptModifyField(field);
+        std::getline(std::cin, answer);
+        applyModifyField(field, answer);
     }
-    
-    std::cout << "Current Description: " << description << std::endl;
-    std::cout << "Enter new description (or press Enter to keep current): ";
-    std::getline(std::cin, newDescription);
-    if (!newDescription.empty()) {
-        description = newDescription;
+    // The owning Vendor reports success, once it has accepted the new name
+    return true;
+}
+
+int Product::getModifyFieldCount() const {
+    return PRODUCT_MODIFY_FIELDS;
+}
+
+void Product::promptModifyField(int field) const {
+    switch (field) {
+        case 0:
+            std::cout << "Current Name: " << name << std::endl;
+            std::cout << "Enter new name (or press Enter to keep current): ";
+            break;
+        case 1:
+            std::cout << "Current Description: " << description.load() << std::endl;
+            std::cout << "Enter new description (or press Enter to keep current): ";
+            break;
+        case 2:
+            std::cout << "Current Rating: " << rating << std::endl;
+            std::cout << "Enter new rating (0-5) (or press Enter to keep current): ";
+            break;
+        case 3:
+            std::cout << "Current Price: $" << formatPrice(price) << std::endl;
+            std::cout << "Enter new price (e.g. 19.99) (or press Enter to keep current): ";
+            break;
     }
-    
-    std::cout << "Current Rating: " << rating << std::endl;
-    std::cout << "Enter new rating (0-5) (or press Enter to keep current): ";
-    std::string ratingStr;
-    std::getline(std::cin, ratingStr);
-    if (!ratingStr.empty()) {
-        try {
-            int newRating = std::stoi(ratingStr);
-            if (newRating >= 0 && newRating <= 5) {
-                rating = newRating;
+}
+
+void Product::applyModifyField(int field, const std::string& answer) {
+    if (answer.empty()) {
+        return;
+    }
+    switch (field) {
+        case 0:
+            name = answer;
+            break;
+        case 1:
+            description.assign(answer);
+            break;
+        case 2:
+            try {
+                int newRating = std::stoi(answer);
+                if (newRating >= 0 && newRating <= 5) {
+                    rating = newRating;
+                } else {
+                    std::cout << "Invalid rating. Using current value." << std::endl;
+                }
+            } catch (...) {
+                std::cout << "Invalid input. Using current value." << std::endl;
+            }
+            break;
+        case 3: {
+            Cents newPrice;
+            if (parsePrice(answer, newPrice)) {
+                price = newPrice;
             } else {
-                std::cout << "Invalid rating. Using current value." << std::endl;
+                std::cout << "Invalid price. Using current value." << std::endl;
             }
-        } catch (...) {
-            std::cout << "Invalid input. Using current value." << std::endl;
+            break;
         }
     }
-    
-    std::cout << "Product modified successfully!" << std::endl;
-    return true;
+    touch();
+}
+
+// Memory accounting (the description is counted by ColdTextStore)
+std::size_t Product::getStringHeapBytes() const {
+    return stringHeapBytes(name);
 }
 
 // Operator overloading implementation
@@ -106,55 +287,65 @@ Media::Media() : Product(), type(""), targetAudience("") {}
 
 Media::Media(const std::string& name, const std::string& description, 
              const std::string& type, const std::string& targetAudience,
-             int rating, int soldCount)
-    : Product(name, description, rating, soldCount), type(type), targetAudience(targetAudience) {}
+             int rating, int soldCount, Cents price)
+    : Product(name, description, rating, soldCount, price), type(type), targetAudience(targetAudience) {}
 
 // Getters
-std::string Media::getType() const {
+std::string_view Media::getType() const {
     return type;
 }
 
-std::string Media::getTargetAudience() const {
+std::string_view Media::getTargetAudience() const {
     return targetAudience;
 }
 
 // Setters
 void Media::setType(const std::string& type) {
     this->type = type;
+    touch();
 }
 
 void Media::setTargetAudience(const std::string& targetAudience) {
     this->targetAudience = targetAudience;
+    touch();
 }
 
-// Override display method
-void Media::display() const {
-    Product::display();
-    std::cout << "Type: " << type << std::endl;
-    std::cout << "Target Audience: " << targetAudience << std::endl;
+// Override render method
+void Media::render(std::ostream& out) const {
+    Product::render(out);
+    out << "Type: " << type << std::endl;
+    out << "Target Audience: " << targetAudience << std::endl;
 }
 
-// Override modify method
-bool Media::modify() {
-    // First modify base class attributes
-    Product::modify();
-    
-    // Then modify media-specific attributes
-    std::string newType, newTargetAudience;
-    
-    std::cout << "Enter new type (or press Enter to keep current): ";
-    std::getline(std::cin, newType);
-    if (!newType.empty()) {
-        type = newType;
+// Modify fields: the base fields, then type and target audience
+int Media::getModifyFieldCount() const {
+    return PRODUCT_MODIFY_FIELDS + 2;
+}
+
+void Media::promptModifyField(int field) const {
+    if (field == PRODUCT_MODIFY_FIELDS) {
+        std::cout << "Enter new type (or press Enter to keep current): ";
+    } else if (field == PRODUCT_MODIFY_FIELDS + 1) {
+        std::cout << "Enter new target audience (or press Enter to keep current): ";
+    } else {
+        Product::promptModifyField(field);
     }
-    
-    std::cout << "Enter new target audience (or press Enter to keep current): ";
-    std::getline(std::cin, newTargetAudience);
-    if (!newTargetAudience.empty()) {
-        targetAudience = newTargetAudience;
+}
+
+void Media::applyModifyField(int field, const std::string& answer) {
+    if (field == PRODUCT_MODIFY_FIELDS) {
+        if (!answer.empty()) {
+            type = answer;
+            touch();
+        }
+    } else if (field == PRODUCT_MODIFY_FIELDS + 1) {
+        if (!answer.empty()) {
+            targetAudience = answer;
+            touch();
+        }
+    } else {
+        Product::applyModifyField(field, answer);
     }
-    
-    return true;
 }
 
 // Override sell method
@@ -165,6 +356,7 @@ bool Media::sell(int quantity) {
     
     // Increment sold count by quantity
     soldCount += quantity;
+    touch();
     
     // Display access code
     std::cout << "Product sold! Your one-time access code is: " << accessCode << std::endl;
@@ -173,79 +365,165 @@ bool Media::sell(int quantity) {
     return true;
 }
 
+// Memory accounting
+std::size_t Media::getStringHeapBytes() const {
+    return Product::getStringHeapBytes() + stringHeapBytes(type) + stringHeapBytes(targetAudience);
+}
+
+std::size_t Media::getObjectSize() const {
+    return sizeof(Media);
+}
+
+// Batched sell: media has no inventory, so every request succeeds
+int Media::sellBatch(const std::vector<int>& quantities, std::vector<bool>& accepted) {
+    int total = 0;
+    accepted.assign(quantities.size(), true);
+    for (int requested : quantities) {
+        total += requested;
+    }
+    soldCount += total;
+    touch();
+    return total;
+}
+
+// Reservation class implementations
+Reservation::Reservation(const Good* owner, int units, std::chrono::steady_clock::time_point deadline)
+    : owner(owner), units(units), deadline(deadline), state(Held) {}
+
+int Reservation::getUnits() const {
+    return units;
+}
+
+std::chrono::steady_clock::time_point Reservation::getDeadline() const {
+    return deadline;
+}
+
+bool Reservation::isHeld() const {
+    return state.load(std::memory_order_acquire) == Held;
+}
+
 // Good class implementations
+const unsigned Good::SWEEP_INTERVAL;
+
 // Constructors
-Good::Good() : Product(), expirationDate(""), quantity(0) {}
+Good::Good() : Product(), expirationDate(""), quantity(0), reservedQuantity(0),
+               pendingReservations(nullptr), reservationsMade(0), backorderCount(0) {}
 
 Good::Good(const std::string& name, const std::string& description, 
          const std::string& expirationDate, int quantity,
-         int rating, int soldCount)
-    : Product(name, description, rating, soldCount), expirationDate(expirationDate), quantity(quantity) {}
+         int rating, int soldCount, Cents price)
+    : Product(name, description, rating, soldCount, price), expirationDate(expirationDate), quantity(quantity),
+      reservedQuantity(0), pendingReservations(nullptr), reservationsMade(0), backorderCount(0) {}
+
+// Destructor - free the pending list and tell waiting backorders they lost
+Good::~Good() {
+    PendingReservation* entry = pendingReservations.exchange(nullptr);
+    while (entry != nullptr) {
+        PendingReservation* next = entry->next;
+        delete entry;
+        entry = next;
+    }
+    for (Backorder& waiting : backorders) {
+        if (waiting.done) {
+            waiting.done(false);
+        }
+    }
+}
 
 // Getters
-std::string Good::getExpirationDate() const {
+std::string_view Good::getExpirationDate() const {
     return expirationDate;
 }
 
 int Good::getQuantity() const {
-    return quantity;
+    return quantity.load(std::memory_order_acquire);
+}
+
+int Good::getReservedQuantity() const {
+    return reservedQuantity.load(std::memory_order_acquire);
+}
+
+int Good::getBackorderCount() const {
+    return backorderCount.load(std::memory_order_acquire);
 }
 
 // Setters
 void Good::setExpirationDate(const std::string& expirationDate) {
     this->expirationDate = expirationDate;
+    touch();
 }
 
 void Good::setQuantity(int quantity) {
-    this->quantity = quantity;
+    this->quantity.store(quantity);
+    touch();
+    drainBackorders();
 }
 
-// Override display method
-void Good::display() const {
-    Product::display();
-    std::cout << "Expiration Date: " << expirationDate << std::endl;
-    std::cout << "Quantity Available: " << quantity << std::endl;
+void Good::restock(int units) {
+    if (units <= 0) {
+        return;
+    }
+    quantity.fetch_add(units);
+    touch();
+    drainBackorders();
 }
 
-// Override modify method
-bool Good::modify() {
-    // First modify base class attributes
-    Product::modify();
-    
-    // Then modify goods-specific attributes
-    std::string newExpirationDate, quantityStr;
-    
-    std::cout << "Enter new expiration date (or press Enter to keep current): ";
-    std::getline(std::cin, newExpirationDate);
-    if (!newExpirationDate.empty()) {
-        expirationDate = newExpirationDate;
+// Override render method
+void Good::render(std::ostream& out) const {
+    Product::render(out);
+    out << "Expiration Date: " << expirationDate << std::endl;
+    out << "Quantity Available: " << quantity << std::endl;
+    int reserved = getReservedQuantity();
+    if (reserved > 0) {
+        out << "Quantity Reserved: " << reserved << std::endl;
     }
-    
-    std::cout << "Enter new quantity (or press Enter to keep current): ";
-    std::getline(std::cin, quantityStr);
-    if (!quantityStr.empty()) {
-        try {
-            int newQuantity = std::stoi(quantityStr);
-            if (newQuantity >= 0) {
-                quantity = newQuantity;
-            } else {
-                std::cout << "Invalid quantity. Using current value." << std::endl;
+}
+
+// Modify fields: the base fields, then expiration date and quantity
+int Good::getModifyFieldCount() const {
+    return PRODUCT_MODIFY_FIELDS + 2;
+}
+
+void Good::promptModifyField(int field) const {
+    if (field == PRODUCT_MODIFY_FIELDS) {
+        std::cout << "Enter new expiration date (or press Enter to keep current): ";
+    } else if (field == PRODUCT_MODIFY_FIELDS + 1) {
+        std::cout << "Enter new quantity (or press Enter to keep current): ";
+    } else {
+        Product::promptModifyField(field);
+    }
+}
+
+void Good::applyModifyField(int field, const std::string& answer) {
+    if (field == PRODUCT_MODIFY_FIELDS) {
+        if (!answer.empty()) {
+            expirationDate = answer;
+            touch();
+        }
+    } else if (field == PRODUCT_MODIFY_FIELDS + 1) {
+        if (!answer.empty()) {
+            try {
+                int newQuantity = std::stoi(answer);
+                if (newQuantity >= 0) {
+                    setQuantity(newQuantity);
+                } else {
+                    std::cout << "Invalid quantity. Using current value." << std::endl;
+                }
+            } catch (...) {
+                std::cout << "Invalid input. Using current value." << std::endl;
             }
-        } catch (...) {
-            std::cout << "Invalid input. Using current value." << std::endl;
         }
+    } else {
+        Product::applyModifyField(field, answer);
     }
-    
-    return true;
 }
 
 // Override sell method - checks quantity
 bool Good::sell(int sellQuantity) {
-    if (quantity >= sellQuantity) {
-        // Decrement quantity
-        quantity -= sellQuantity;
+    if (takeStock(sellQuantity)) {
         // Increment sold count
         soldCount += sellQuantity;
+        touch();
         
         std::cout << "Product sold! Quantity sold: " << sellQuantity << std::endl;
         std::cout << "Remaining quantity: " << quantity << std::endl;
@@ -256,3 +534,188 @@ bool Good::sell(int sellQuantity) {
     }
 }
 
+// Memory accounting
+std::size_t Good::getStringHeapBytes() const {
+    return Product::getStringHeapBytes() + stringHeapBytes(expirationDate);
+}
+
+std::size_t Good::getObjectSize() const {
+    return sizeof(Good);
+}
+
+// Batched sell: accept requests in order while stock lasts, then update once
+int Good::sellBatch(const std::vector<int>& quantities, std::vector<bool>& accepted) {
+    int available = quantity.load(std::memory_order_acquire);
+    int remaining;
+    int total;
+    do {
+        // Reservations and direct sells may move the stock; redo the pass if they did
+        remaining = available;
+        total = 0;
+        accepted.assign(quantities.size(), false);
+        for (size_t i = 0; i < quantities.size(); i++) {
+            if (remaining >= quantities[i]) {
+                remaining -= quantities[i];
+                total += quantities[i];
+                accepted[i] = true;
+            }
+        }
+    } while (!quantity.compare_exchange_weak(available, remaining, std::memory_order_acq_rel));
+    soldCount += total;
+    touch();
+    return total;
+}
+
+// Reservations
+std::shared_ptr<Reservation> Good::reserve(int units, std::chrono::milliseconds timeout) {
+    if (units <= 0) {
+        return nullptr;
+    }
+    if ((reservationsMade.fetch_add(1, std::memory_order_relaxed) + 1) % SWEEP_INTERVAL == 0) {
+        expireReservations();
+    }
+    if (!takeStock(units)) {
+        // Stale holds may be sitting on the stock we need
+        if (expireReservations() == 0 || !takeStock(units)) {
+            return nullptr;
+        }
+    }
+    reservedQuantity.fetch_add(units, std::memory_order_acq_rel);
+    touch();
+    
+    std::shared_ptr<Reservation> reservation(
+        new Reservation(this, units, std::chrono::steady_clock::now() + timeout));
+    
+    // Lock-free push so the expiry sweep can find the hold later
+    PendingReservation* entry = new PendingReservation{reservation, pendingReservations.load(std::memory_order_relaxed)};
+    while (!pendingReservations.compare_exchange_weak(entry->next, entry,
+                                                      std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return reservation;
+}
+
+bool Good::commit(const std::shared_ptr<Reservation>& reservation) {
+    if (!reservation || reservation->owner != this) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() > reservation->deadline) {
+        if (settle(*reservation, Reservation::Expired)) {
+            returnStock(reservation->units);
+        }
+        return false;
+    }
+    if (!settle(*reservation, Reservation::Committed)) {
+        return false;
+    }
+    reservedQuantity.fetch_sub(reservation->units, std::memory_order_acq_rel);
+    soldCount += reservation->units;
+    touch();
+    return true;
+}
+
+bool Good::release(const std::shared_ptr<Reservation>& reservation) {
+    if (!reservation || reservation->owner != this || !settle(*reservation, Reservation::Released)) {
+        return false;
+    }
+    returnStock(reservation->units);
+    return true;
+}
+
+int Good::expireReservations() {
+    std::unique_lock<std::mutex> guard(sweepLock, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        return 0;
+    }
+    
+    // Detach the whole stack; holds pushed meanwhile start a new one
+    PendingReservation* entry = pendingReservations.exchange(nullptr, std::memory_order_acquire);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    int expired = 0;
+    while (entry != nullptr) {
+        PendingReservation* next = entry->next;
+        Reservation& reservation = *entry->reservation;
+        if (reservation.isHeld() && now > reservation.deadline && settle(reservation, Reservation::Expired)) {
+            returnStock(reservation.units);
+            expired++;
+        }
+        
+        if (reservation.isHeld()) {
+            // Still live: put it back for a later sweep
+            entry->next = pendingReservations.load(std::memory_order_relaxed);
+            while (!pendingReservations.compare_exchange_weak(entry->next, entry,
+                                                              std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        } else {
+            delete entry;
+        }
+        entry = next;
+    }
+    return expired;
+}
+
+void Good::placeBackorder(int units, std::function<void(bool)> done) {
+    if (units <= 0) {
+        done(false);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(backorderLock);
+        backorders.push_back(Backorder{units, std::move(done)});
+        backorderCount.fetch_add(1);
+    }
+    // The stock may already be there
+    drainBackorders();
+}
+
+// Reservation helpers
+bool Good::takeStock(int units) {
+    assert(units > 0);
+    int available = quantity.load();
+    while (available >= units) {
+        if (quantity.compare_exchange_weak(available, available - units)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Good::settle(Reservation& reservation, int newState) {
+    int expected = Reservation::Held;
+    return reservation.state.compare_exchange_strong(expected, newState, std::memory_order_acq_rel);
+}
+
+void Good::returnStock(int units) {
+    reservedQuantity.fetch_sub(units, std::memory_order_acq_rel);
+    quantity.fetch_add(units);
+    touch();
+    drainBackorders();
+}
+
+void Good::drainBackorders() {
+    // Sequentially consistent with the stock update before it and the
+    // count update in placeBackorder(): either this sees the new
+    // backorder or placeBackorder()'s drain sees the new stock
+    if (backorderCount.load() == 0) {
+        return;
+    }
+    
+    std::vector<std::function<void(bool)> > filled;
+    {
+        std::lock_guard<std::mutex> guard(backorderLock);
+        // Strict FIFO: a request that does not fit holds back the ones behind it
+        while (!backorders.empty() && takeStock(backorders.front().units)) {
+            soldCount += backorders.front().units;
+            filled.push_back(std::move(backorders.front().done));
+            backorders.pop_front();
+            backorderCount.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    if (!filled.empty()) {
+        touch();
+    }
+    for (std::function<void(bool)>& done : filled) {
+        if (done) {
+            done(true);
+        }
+    }
+}
@@ -1,8 +1,33 @@
 #ifndef PRODUCT_H
 #define PRODUCT_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <vector>
+#include "ColdText.h"
+
+/**
+ * @brief Stable product identifier assigned by the owning Vendor
+ *
+ * The high 32 bits hold the slot generation and the low 32 bits the slot
+ * index, so an ID stops resolving once its product is deleted even if the
+ * slot is reused. 0 means the product has not been added to a vendor.
+ */
+typedef std::uint64_t ProductId;
+
+/**
+ * @brief Money as a whole number of cents (fixed point, two decimals)
+ */
+typedef std::int64_t Cents;
 
 /**
  * @brief Abstract base class representing a generic product.
@@ -13,10 +38,26 @@
  */
 class Product {
 protected:
-    std::string name;          ///< Product name
-    std::string description;   ///< Product description
+    // Hot fields first: with the vtable pointer they fill the object's first 64 bytes
     int rating;                ///< Customer rating (typically 0-5)
-    int soldCount;             ///< Number of units sold
+    std::atomic<int> soldCount; ///< Number of units sold (atomic: Good reservations commit concurrently)
+    ProductId id;              ///< Stable ID from the owning vendor (0 if none)
+    Cents price;               ///< Unit price in cents
+    std::atomic<std::uint64_t> revision; ///< Bumped by touch() on every change display() would show
+    mutable std::uint64_t renderedRevision; ///< revision the cached text was rendered at (0: none)
+    mutable std::atomic<bool> renderBusy;   ///< Held while a thread fills or copies the cache
+    ColdText description;      ///< Product description, loaded on access
+    mutable ColdText rendered; ///< Cached display() text, dropped when the cold store needs room
+    std::string name;          ///< Product name
+
+    static const int PRODUCT_MODIFY_FIELDS = 4; ///< Fields Product itself prompts for in modify()
+
+    /**
+     * @brief Marks the product changed so display() renders it again
+     * @pre Called after the change is made
+     * @post The cached display text is stale
+     */
+    void touch();
 
 public:
     /**
@@ -32,10 +73,12 @@ public:
      * @param description The product description
      * @param rating The initial product rating (default 0)
      * @param soldCount The initial number of units sold (default 0)
+     * @param price The unit price in cents (default 0)
      * @pre None
      * @post A Product object is created with the specified values
      */
-    Product(const std::string& name, const std::string& description, int rating = 0, int soldCount = 0);
+    Product(const std::string& name, const std::string& description, int rating = 0, int soldCount = 0,
+            Cents price = 0);
     
     /**
      * @brief Virtual destructor to ensure proper cleanup of derived classes
@@ -46,15 +89,21 @@ public:
     
     /**
      * @brief Gets the product name
-     * @return The product name as a string
+     * @return A view of the product name, valid until it is next changed
+     */
+    std::string_view getName() const;
+    
+    /**
+     * @brief Gets the product description, reading it back from disk if it was paged out
+     * @return The loaded description, valid while the returned view exists
      */
-    std::string getName() const;
+    ColdText::View getDescription() const;
     
     /**
-     * @brief Gets the product description
-     * @return The product description as a string
+     * @brief Gets the product description without loading it
+     * @return The handle; copies share the stored text
      */
-    std::string getDescription() const;
+    const ColdText& getDescriptionText() const;
     
     /**
      * @brief Gets the product rating
@@ -68,6 +117,24 @@ public:
      */
     int getSoldCount() const;
     
+    /**
+     * @brief Gets the product's stable ID
+     * @return The ID assigned by the owning vendor, or 0 if none
+     */
+    ProductId getId() const;
+    
+    /**
+     * @brief Gets the unit price
+     * @return The price in cents
+     */
+    Cents getPrice() const;
+    
+    /**
+     * @brief Gets the revenue earned so far
+     * @return price * soldCount, in cents
+     */
+    Cents getRevenue() const;
+    
     /**
      * @brief Sets the product name
      * @param name The new product name
@@ -100,20 +167,83 @@ public:
      */
     void setSoldCount(int soldCount);
     
+    /**
+     * @brief Sets the unit price
+     * @param price The new price in cents
+     * @pre price should be non-negative
+     * @post The product price is updated
+     */
+    void setPrice(Cents price);
+    
+    /**
+     * @brief Parses a price such as "19.99", "$5" or "0.5"
+     * @param text The price as typed
+     * @param price Set to the price in cents on success
+     * @return True if text is a non-negative amount with at most two decimals, false otherwise
+     */
+    static bool parsePrice(const std::string& text, Cents& price);
+    
+    /**
+     * @brief Formats cents as dollars and cents
+     * @param amount The amount in cents
+     * @return The amount as text, e.g. "19.99"
+     */
+    static std::string formatPrice(Cents amount);
+    
+    /**
+     * @brief Sets the product's stable ID
+     * @param id The new ID
+     * @pre Called only by the owning Vendor
+     * @post The product ID is updated
+     */
+    void setId(ProductId id);
+    
     /**
      * @brief Displays product information to the console
      * @pre None
-     * @post Product information is displayed
+     * @post Product information is displayed. The text is rendered once and
+     *       then copied from a cache until the product next changes.
+     */
+    void display() const;
+    
+    /**
+     * @brief Formats the product the way display() prints it
+     * @param out The stream to write to
+     * @post Subclasses append their own fields after the base fields
      */
-    virtual void display() const;
+    virtual void render(std::ostream& out) const;
     
     /**
      * @brief Modifies product details based on user input
      * @pre None
-     * @post Product details are updated if the modification is successful
+     * @post Each field from getModifyFieldCount() is prompted for on std::cin and applied;
+     *       nothing is printed once the fields are read
      * @return True if the modification was successful, false otherwise
      */
-    virtual bool modify();
+    bool modify();
+    
+    /**
+     * @brief Gets the number of fields modify() prompts for
+     * @return The field count
+     */
+    virtual int getModifyFieldCount() const;
+    
+    /**
+     * @brief Prints the prompt for one modify() field
+     * @param field The field index, from 0 to getModifyFieldCount() - 1
+     * @pre None
+     * @post The current value (for base fields) and the prompt are printed
+     */
+    virtual void promptModifyField(int field) const;
+    
+    /**
+     * @brief Applies the answer to one modify() field
+     * @param field The field index, from 0 to getModifyFieldCount() - 1
+     * @param answer The entered line; an empty line keeps the current value
+     * @pre None
+     * @post The field is updated, or an invalid answer is reported and ignored
+     */
+    virtual void applyModifyField(int field, const std::string& answer);
     
     /**
      * @brief Pure virtual method for selling a product
@@ -124,6 +254,28 @@ public:
      */
     virtual bool sell(int quantity) = 0;
     
+    /**
+     * @brief Applies a batch of sell requests in one update, without console output
+     * @param quantities The requested quantities, in arrival order
+     * @param accepted Filled with one entry per request telling whether it was sold
+     * @pre The caller serializes access to this product
+     * @post soldCount (and any stock) reflect every accepted request
+     * @return The total number of units sold
+     */
+    virtual int sellBatch(const std::vector<int>& quantities, std::vector<bool>& accepted) = 0;
+    
+    /**
+     * @brief Gets the heap bytes owned by this product's string fields
+     * @return The string heap bytes, including subclass fields
+     */
+    virtual std::size_t getStringHeapBytes() const;
+    
+    /**
+     * @brief Gets sizeof() of the product's dynamic type
+     * @return The object size in bytes
+     */
+    virtual std::size_t getObjectSize() const = 0;
+    
     /**
      * @brief Equality comparison operator
      * @param otherProduct The product to compare with
@@ -159,24 +311,25 @@ public:
      * @param targetAudience The intended audience for this media
      * @param rating The initial product rating (default 0)
      * @param soldCount The initial number of units sold (default 0)
+     * @param price The unit price in cents (default 0)
      * @pre None
      * @post A Media object is created with the specified values
      */
     Media(const std::string& name, const std::string& description, 
           const std::string& type, const std::string& targetAudience,
-          int rating = 0, int soldCount = 0);
+          int rating = 0, int soldCount = 0, Cents price = 0);
     
     /**
      * @brief Gets the media type
-     * @return The media type as a string
+     * @return A view of the media type, valid until it is next changed
      */
-    std::string getType() const;
+    std::string_view getType() const;
     
     /**
      * @brief Gets the target audience
-     * @return The target audience as a string
+     * @return A view of the target audience, valid until it is next changed
      */
-    std::string getTargetAudience() const;
+    std::string_view getTargetAudience() const;
     
     /**
      * @brief Sets the media type
@@ -195,19 +348,29 @@ public:
     void setTargetAudience(const std::string& targetAudience);
     
     /**
-     * @brief Displays media product information including type and target audience
-     * @pre None
-     * @post Media product information is displayed
+     * @brief Formats media product information including type and target audience
+     * @param out The stream to write to
      */
-    void display() const override;
+    void render(std::ostream& out) const override;
     
     /**
-     * @brief Modifies media product details based on user input
-     * @pre None
-     * @post Media product details are updated if the modification is successful
-     * @return True if the modification was successful, false otherwise
+     * @brief Gets the number of fields modify() prompts for
+     * @return The base fields plus type and target audience
+     */
+    int getModifyFieldCount() const override;
+    
+    /**
+     * @brief Prints the prompt for one modify() field
+     * @param field The field index, from 0 to getModifyFieldCount() - 1
      */
-    bool modify() override;
+    void promptModifyField(int field) const override;
+    
+    /**
+     * @brief Applies the answer to one modify() field
+     * @param field The field index, from 0 to getModifyFieldCount() - 1
+     * @param answer The entered line; an empty line keeps the current value
+     */
+    void applyModifyField(int field, const std::string& answer) override;
     
     /**
      * @brief Sells a media product (typically generates access code)
@@ -217,6 +380,68 @@ public:
      * @return True if the sale was successful, false otherwise
      */
     bool sell(int quantity) override;
+    
+    /**
+     * @brief Sells every request in the batch (media has no stock limit)
+     * @param quantities The requested quantities, in arrival order
+     * @param accepted Filled with true for every request
+     * @pre The caller serializes access to this product
+     * @post soldCount is increased by the sum of quantities
+     * @return The total number of units sold
+     */
+    int sellBatch(const std::vector<int>& quantities, std::vector<bool>& accepted) override;
+    
+    /**
+     * @brief Gets the heap bytes owned by the product and media string fields
+     * @return The string heap bytes
+     */
+    std::size_t getStringHeapBytes() const override;
+    
+    /**
+     * @brief Gets sizeof(Media)
+     * @return The object size in bytes
+     */
+    std::size_t getObjectSize() const override;
+};
+
+class Good;
+
+/**
+ * @brief Units of a Good held for an in-flight checkout
+ *
+ * Obtained from Good::reserve() and settled exactly once: by Good::commit(),
+ * Good::release(), or expiry once its deadline passes.
+ */
+class Reservation {
+public:
+    /**
+     * @brief Gets the number of units held
+     * @return The reserved units
+     */
+    int getUnits() const;
+    
+    /**
+     * @brief Gets the time after which the hold may expire
+     * @return The deadline
+     */
+    std::chrono::steady_clock::time_point getDeadline() const;
+    
+    /**
+     * @brief Checks whether the units are still held
+     * @return True if not yet committed, released or expired, false otherwise
+     */
+    bool isHeld() const;
+
+private:
+    friend class Good;
+    enum State { Held, Committed, Released, Expired };
+    
+    Reservation(const Good* owner, int units, std::chrono::steady_clock::time_point deadline);
+    
+    const Good* owner;                                ///< The good holding the units
+    const int units;                                  ///< Units held
+    const std::chrono::steady_clock::time_point deadline; ///< When the hold may expire
+    std::atomic<int> state;                           ///< A State; changes from Held exactly once
 };
 
 /**
@@ -228,7 +453,57 @@ public:
 class Good : public Product {
 private:
     std::string expirationDate; ///< Date when the product expires (if applicable)
-    int quantity;               ///< Available inventory quantity
+    std::atomic<int> quantity;  ///< Available inventory quantity, not counting reserved units
+    std::atomic<int> reservedQuantity; ///< Units held by outstanding reservations
+    
+    /// Reservation awaiting commit, release or expiry; kept on a lock-free stack
+    struct PendingReservation {
+        std::shared_ptr<Reservation> reservation; ///< The hold
+        PendingReservation* next;                 ///< Next entry on the stack
+    };
+    std::atomic<PendingReservation*> pendingReservations; ///< Holds the expiry sweep still has to look at
+    std::atomic<unsigned> reservationsMade;   ///< Triggers a sweep every SWEEP_INTERVAL reservations
+    std::mutex sweepLock;                     ///< Lets one thread sweep at a time
+    
+    /// Request waiting for stock, filled in arrival order on restock
+    struct Backorder {
+        int units;                       ///< Units wanted
+        std::function<void(bool)> done;  ///< Called with true when filled, false if the good is destroyed
+    };
+    std::deque<Backorder> backorders;    ///< FIFO of waiting requests
+    std::atomic<int> backorderCount;     ///< backorders.size(), readable without the lock
+    std::mutex backorderLock;            ///< Guards backorders
+    
+    static const unsigned SWEEP_INTERVAL = 1024; ///< Reservations between opportunistic expiry sweeps
+    
+    /**
+     * @brief Takes units from the available stock with a compare-and-swap loop
+     * @param units The units to take
+     * @pre units > 0
+     * @return True if enough stock was available, false otherwise (nothing taken)
+     */
+    bool takeStock(int units);
+    
+    /**
+     * @brief Moves a reservation out of Held
+     * @param reservation The reservation
+     * @param newState Committed, Released or Expired
+     * @return True if this call settled it, false if it was already settled
+     */
+    bool settle(Reservation& reservation, int newState);
+    
+    /**
+     * @brief Returns a settled reservation's units to the available stock
+     * @param units The units
+     * @post Waiting backorders are filled from the returned units
+     */
+    void returnStock(int units);
+    
+    /**
+     * @brief Fills waiting backorders, oldest first, while stock lasts
+     * @post Filled requests are removed and their callbacks run outside the lock
+     */
+    void drainBackorders();
 
 public:
     /**
@@ -246,25 +521,45 @@ public:
      * @param quantity The initial inventory quantity
      * @param rating The initial product rating (default 0)
      * @param soldCount The initial number of units sold (default 0)
+     * @param price The unit price in cents (default 0)
      * @pre None
      * @post A Good object is created with the specified values
      */
     Good(const std::string& name, const std::string& description, 
          const std::string& expirationDate, int quantity,
-         int rating = 0, int soldCount = 0);
+         int rating = 0, int soldCount = 0, Cents price = 0);
+    
+    /**
+     * @brief Destructor
+     * @pre No other thread is using the good
+     * @post Waiting backorders are told they were not filled
+     */
+    ~Good();
     
     /**
      * @brief Gets the expiration date
-     * @return The expiration date as a string
+     * @return A view of the expiration date, valid until it is next changed
      */
-    std::string getExpirationDate() const;
+    std::string_view getExpirationDate() const;
     
     /**
      * @brief Gets the current inventory quantity
-     * @return The quantity as an integer
+     * @return The units available to sell or reserve (reserved units are not included)
      */
     int getQuantity() const;
     
+    /**
+     * @brief Gets the units held by outstanding reservations
+     * @return The reserved quantity
+     */
+    int getReservedQuantity() const;
+    
+    /**
+     * @brief Gets the number of backorders waiting for stock
+     * @return The backorder count
+     */
+    int getBackorderCount() const;
+    
     /**
      * @brief Sets the expiration date
      * @param expirationDate The new expiration date
@@ -275,26 +570,95 @@ public:
     
     /**
      * @brief Sets the inventory quantity
-     * @param quantity The new quantity
+     * @param quantity The new quantity of unreserved stock
      * @pre quantity should be non-negative
-     * @post The inventory quantity is updated
+     * @post The inventory quantity is updated and waiting backorders are
+     *       filled from it in arrival order
      */
     void setQuantity(int quantity);
     
     /**
-     * @brief Displays good information including expiration date and quantity
-     * @pre None
-     * @post Good information is displayed
+     * @brief Adds stock, safely alongside concurrent sells and reservations
+     * @param units The units received
+     * @pre Safe to call from any thread
+     * @post The available quantity grows by units and waiting backorders are filled from it
      */
-    void display() const override;
+    void restock(int units);
     
     /**
-     * @brief Modifies good details based on user input
-     * @pre None
-     * @post Good details are updated if the modification is successful
-     * @return True if the modification was successful, false otherwise
+     * @brief Holds units for a checkout without selling them yet
+     * @param units The units to hold
+     * @param timeout How long the hold lasts before it may expire
+     * @pre Safe to call from any thread
+     * @post On success the units move from the available to the reserved quantity
+     * @return The reservation, or nullptr if units is not positive or not
+     *         enough stock is available
+     */
+    std::shared_ptr<Reservation> reserve(int units,
+                                         std::chrono::milliseconds timeout = std::chrono::minutes(10));
+    
+    /**
+     * @brief Sells the units of a reservation
+     * @param reservation A reservation from this good's reserve()
+     * @pre Safe to call from any thread
+     * @post On success the units leave the reserved quantity and are added to soldCount.
+     *       A reservation past its deadline is expired instead
+     * @return True if the units were sold, false if the reservation was not held or had expired
+     */
+    bool commit(const std::shared_ptr<Reservation>& reservation);
+    
+    /**
+     * @brief Gives back the units of a reservation
+     * @param reservation A reservation from this good's reserve()
+     * @pre Safe to call from any thread
+     * @post On success the units return to the available quantity
+     * @return True if the reservation was held, false if it was already settled
+     */
+    bool release(const std::shared_ptr<Reservation>& reservation);
+    
+    /**
+     * @brief Returns the units of every reservation past its deadline
+     * @pre Safe to call from any thread; returns 0 at once if another thread is sweeping
+     * @post Expired units are available again and backorders are filled from them
+     * @return The number of reservations expired
      */
-    bool modify() override;
+    int expireReservations();
+    
+    /**
+     * @brief Queues a request to be filled when stock becomes available
+     * @param units The units wanted
+     * @param done Called with true once the units are sold to the request
+     *             (possibly before this returns), or false right away if units <= 0,
+     *             or false if the good is destroyed first
+     * @pre Safe to call from any thread
+     * @post The request is filled in arrival order after earlier backorders
+     */
+    void placeBackorder(int units, std::function<void(bool)> done);
+    
+    /**
+     * @brief Formats good information including expiration date and quantity
+     * @param out The stream to write to
+     */
+    void render(std::ostream& out) const override;
+    
+    /**
+     * @brief Gets the number of fields modify() prompts for
+     * @return The base fields plus expiration date and quantity
+     */
+    int getModifyFieldCount() const override;
+    
+    /**
+     * @brief Prints the prompt for one modify() field
+     * @param field The field index, from 0 to getModifyFieldCount() - 1
+     */
+    void promptModifyField(int field) const override;
+    
+    /**
+     * @brief Applies the answer to one modify() field
+     * @param field The field index, from 0 to getModifyFieldCount() - 1
+     * @param answer The entered line; an empty line keeps the current value
+     */
+    void applyModifyField(int field, const std::string& answer) override;
     
     /**
      * @brief Sells a quantity of the good from inventory
@@ -305,6 +669,28 @@ public:
      * @return True if the sale was successful, false otherwise
      */
     bool sell(int quantity) override;
+    
+    /**
+     * @brief Sells requests in arrival order while stock lasts
+     * @param quantities The requested quantities, in arrival order
+     * @param accepted Filled with true for each request that fit in the remaining stock
+     * @pre The caller serializes access to this product
+     * @post quantity and soldCount are updated once for the whole batch
+     * @return The total number of units sold
+     */
+    int sellBatch(const std::vector<int>& quantities, std::vector<bool>& accepted) override;
+    
+    /**
+     * @brief Gets the heap bytes owned by the product and good string fields
+     * @return The string heap bytes
+     */
+    std::size_t getStringHeapBytes() const override;
+    
+    /**
+     * @brief Gets sizeof(Good)
+     * @return The object size in bytes
+     */
+    std::size_t getObjectSize() const override;
 };
 
 #endif // PRODUCT_H
@@ -0,0 +1,117 @@
+#ifndef RATING_HISTOGRAM_H
+#define RATING_HISTOGRAM_H
+
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @brief Count of products at each rating, kept up to date as ratings change
+ *
+ * Every query walks at most MAX_RATING + 1 buckets, so average, median and
+ * distribution cost O(1) no matter how many products are counted.
+ */
+struct RatingHistogram {
+    static const int MAX_RATING = 5;   ///< Highest rating; ratings are 0..MAX_RATING
+
+    int counts[MAX_RATING + 1];        ///< Products at each rating
+    int total;                         ///< Products counted
+    long long ratingSum;               ///< Sum of the counted ratings
+
+    /**
+     * @brief Default constructor
+     * @post No products are counted
+     */
+    RatingHistogram() : counts(), total(0), ratingSum(0) {}
+
+    /**
+     * @brief Maps any rating onto a bucket
+     * @param rating The rating
+     * @return rating clamped to 0..MAX_RATING
+     */
+    static int bucketFor(int rating) {
+        return rating < 0 ? 0 : (rating > MAX_RATING ? MAX_RATING : rating);
+    }
+
+    /**
+     * @brief Counts one product
+     * @param rating The product's rating
+     */
+    void add(int rating) {
+        int bucket = bucketFor(rating);
+        counts[bucket]++;
+        total++;
+        ratingSum += bucket;
+    }
+
+    /**
+     * @brief Stops counting one product
+     * @param rating The rating the product was counted with
+     */
+    void remove(int rating) {
+        int bucket = bucketFor(rating);
+        counts[bucket]--;
+        total--;
+        ratingSum -= bucket;
+    }
+
+    /**
+     * @brief Adds another histogram's counts to this one
+     * @param other The histogram to merge in
+     * @return A reference to this histogram
+     */
+    RatingHistogram& operator+=(const RatingHistogram& other) {
+        for (int rating = 0; rating <= MAX_RATING; rating++) {
+            counts[rating] += other.counts[rating];
+        }
+        total += other.total;
+        ratingSum += other.ratingSum;
+        return *this;
+    }
+
+    /**
+     * @brief Gets the mean rating
+     * @return The average, or 0 if nothing is counted
+     */
+    double average() const {
+        return total == 0 ? 0.0 : static_cast<double>(ratingSum) / total;
+    }
+
+    /**
+     * @brief Gets the median rating
+     * @return The lower median, or 0 if nothing is counted
+     */
+    int median() const {
+        int seen = 0;
+        for (int rating = 0; rating <= MAX_RATING; rating++) {
+            seen += counts[rating];
+            if (2 * seen >= total && total > 0) {
+                return rating;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Prints the average, median and distribution
+     * @param out The stream to print to
+     */
+    void display(std::ostream& out = std::cout) const {
+        if (total == 0) {
+            out << "Average Rating: none yet" << std::endl;
+            return;
+        }
+        std::ios::fmtflags saved = out.flags();
+        std::streamsize savedPrecision = out.precision();
+        out << "Average Rating: " << std::fixed << std::setprecision(2) << average()
+            << " (median " << median() << ")" << std::endl;
+        out.flags(saved);
+        out.precision(savedPrecision);
+        out << "Rating Distribution:";
+        for (int rating = 0; rating <= MAX_RATING; rating++) {
+            out << " " << rating << ":" << counts[rating];
+        }
+        out << std::endl;
+    }
+};
+
+#endif // RATING_HISTOGRAM_H
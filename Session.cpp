@@ -0,0 +1,276 @@
+#include "Session.h"
+#include <exception>
+#include <iostream>
+#include <new>
+
+thread_local Session* Session::active = nullptr;
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Points std::cout (and the active session) at a session for one resume
+class ActiveScope {
+public:
+    ActiveScope(Session*& active, Session* session, std::streambuf* output)
+        : active(active), savedActive(active), savedOutput(std::cout.rdbuf(output)) {
+        active = session;
+    }
+    ~ActiveScope() {
+        std::cout.rdbuf(savedOutput);
+        active = savedActive;
+    }
+
+private:
+    Session*& active;
+    Session* savedActive;
+    std::streambuf* savedOutput;
+};
+
+} // namespace
+
+// SessionTask
+void SessionTask::promise_type::unhandled_exception() {
+    std::terminate();
+}
+
+void* SessionTask::promise_type::operator new(std::size_t size) {
+    if (Session::active != nullptr) {
+        Session::active->frameBytes += size;
+    }
+    return ::operator new(size);
+}
+
+void SessionTask::promise_type::operator delete(void* frame, std::size_t size) {
+    if (Session::active != nullptr) {
+        Session::active->frameBytes -= size;
+    }
+    ::operator delete(frame);
+}
+
+SessionTask::SessionTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+SessionTask::SessionTask(SessionTask&& other) noexcept : handle(other.handle) {
+    other.handle = nullptr;
+}
+
+SessionTask::~SessionTask() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+std::coroutine_handle<> SessionTask::await_suspend(std::coroutine_handle<> awaiter) noexcept {
+    handle.promise().continuation = awaiter;
+    return handle;
+}
+
+bool SessionTask::await_resume() const noexcept {
+    return handle.promise().result;
+}
+
+// Session
+Session::Session(std::streambuf* output)
+    : flow(nullptr), waitingMode(ReadLine), inputPos(0), inputClosed(false), started(false),
+      output(output != nullptr ? output : &collected), frameBytes(0) {}
+
+Session::~Session() {
+    // Frames of a suspended flow are freed against this session
+    ActiveScope scope(active, this, std::cout.rdbuf());
+    if (flow.handle) {
+        flow.handle.destroy();
+        flow.handle = nullptr;
+    }
+}
+
+void Session::start() {
+    if (started) {
+        return;
+    }
+    started = true;
+    {
+        ActiveScope scope(active, this, std::cout.rdbuf());
+        SessionTask task = run();
+        flow.handle = task.handle;
+        task.handle = nullptr;
+    }
+    resume(flow.handle);
+}
+
+void Session::feed(const std::string& bytes) {
+    compactInput();
+    input += bytes;
+    if (waiting && inputReady(waitingMode)) {
+        std::coroutine_handle<> next = waiting;
+        waiting = nullptr;
+        resume(next);
+    }
+}
+
+void Session::closeInput() {
+    inputClosed = true;
+    if (waiting) {
+        std::coroutine_handle<> next = waiting;
+        waiting = nullptr;
+        resume(next);
+    }
+}
+
+void Session::drive(std::istream& in) {
+    start();
+    std::string line;
+    while (!isFinished()) {
+        if (std::getline(in, line)) {
+            line += '\n';
+            feed(line);
+        } else {
+            closeInput();
+        }
+    }
+}
+
+bool Session::isFinished() const {
+    return started && flow.handle.done();
+}
+
+bool Session::isWaitingForInput() const {
+    return static_cast<bool>(waiting);
+}
+
+std::string Session::takeOutput() {
+    std::string taken;
+    taken.swap(collected.text);
+    return taken;
+}
+
+std::size_t Session::getFrameBytes() const {
+    return frameBytes;
+}
+
+std::size_t Session::getHeapBytes() const {
+    std::size_t bytes = frameBytes;
+    // Strings short enough for the small-string buffer own no heap memory
+    if (input.capacity() > std::string().capacity()) {
+        bytes += input.capacity() + 1;
+    }
+    if (collected.text.capacity() > std::string().capacity()) {
+        bytes += collected.text.capacity() + 1;
+    }
+    return bytes;
+}
+
+// Reads
+Session::InputAwaiter Session::readWord(std::string& word) {
+    return InputAwaiter(*this, ReadWord, &word);
+}
+
+Session::InputAwaiter Session::readLine(std::string& line) {
+    return InputAwaiter(*this, ReadLine, &line);
+}
+
+Session::InputAwaiter Session::skipLine() {
+    return InputAwaiter(*this, SkipLine, nullptr);
+}
+
+void Session::InputAwaiter::await_suspend(std::coroutine_handle<> waiter) {
+    session.waiting = waiter;
+    session.waitingMode = mode;
+}
+
+void Session::skipChar() {
+    if (inputPos < input.size()) {
+        inputPos++;
+    }
+}
+
+bool Session::atEndOfInput() const {
+    return inputClosed && inputPos >= input.size();
+}
+
+bool Session::inputReady(ReadMode mode) const {
+    if (inputClosed) {
+        return true;
+    }
+    if (mode != ReadWord) {
+        return input.find('\n', inputPos) != std::string::npos;
+    }
+    // A word is complete once whitespace follows it
+    std::size_t pos = inputPos;
+    while (pos < input.size() && isSpace(input[pos])) {
+        pos++;
+    }
+    while (pos < input.size() && !isSpace(input[pos])) {
+        pos++;
+    }
+    return pos < input.size();
+}
+
+bool Session::takeInput(ReadMode mode, std::string* target) {
+    if (mode == ReadWord) {
+        while (inputPos < input.size() && isSpace(input[inputPos])) {
+            inputPos++;
+        }
+        std::size_t end = inputPos;
+        while (end < input.size() && !isSpace(input[end])) {
+            end++;
+        }
+        if (end == inputPos) {
+            target->clear();
+            return false;
+        }
+        target->assign(input, inputPos, end - inputPos);
+        inputPos = end;
+        return true;
+    }
+
+    if (inputPos >= input.size()) {
+        if (target != nullptr) {
+            target->clear();
+        }
+        return mode == SkipLine;
+    }
+    std::size_t newline = input.find('\n', inputPos);
+    std::size_t end = (newline == std::string::npos) ? input.size() : newline;
+    if (mode == ReadLine) {
+        std::size_t length = end - inputPos;
+        if (length > 0 && input[end - 1] == '\r') {
+            length--;
+        }
+        target->assign(input, inputPos, length);
+    }
+    inputPos = (newline == std::string::npos) ? end : newline + 1;
+    return true;
+}
+
+void Session::compactInput() {
+    if (inputPos == 0) {
+        return;
+    }
+    if (inputPos >= input.size()) {
+        input.clear();
+    } else {
+        input.erase(0, inputPos);
+    }
+    inputPos = 0;
+}
+
+// Running
+void Session::resume(std::coroutine_handle<> coroutine) {
+    ActiveScope scope(active, this, output);
+    coroutine.resume();
+}
+
+// OutputBuffer
+int Session::OutputBuffer::overflow(int c) {
+    if (c != traits_type::eof()) {
+        text += static_cast<char>(c);
+    }
+    return c;
+}
+
+std::streamsize Session::OutputBuffer::xsputn(const char* data, std::streamsize count) {
+    text.append(data, static_cast<std::size_t>(count));
+    return count;
+}
@@ -0,0 +1,283 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "Session.h needs C++20 coroutines; compile with -std=c++20"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <istream>
+#include <streambuf>
+#include <string>
+
+class Session;
+
+/**
+ * @brief Coroutine type for session flows
+ *
+ * A task does not start until it is awaited (or, for a session's top-level
+ * flow, until Session::start()). When it finishes, its awaiter resumes
+ * directly, without growing the stack. Every flow reports a bool.
+ */
+class SessionTask {
+public:
+    /// Coroutine promise; frames are counted against the session that creates them
+    struct promise_type {
+        bool result = false;                   ///< Value passed to co_return
+        std::coroutine_handle<> continuation;  ///< Coroutine awaiting this one, if any
+
+        /// Resumes the awaiter once the task is done
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept {
+                std::coroutine_handle<> next = finished.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        SessionTask get_return_object() {
+            return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_value(bool value) { result = value; }
+        void unhandled_exception();
+
+        static void* operator new(std::size_t size);
+        static void operator delete(void* frame, std::size_t size);
+    };
+
+    /**
+     * @brief Move constructor
+     * @post other no longer owns a coroutine
+     */
+    SessionTask(SessionTask&& other) noexcept;
+
+    /**
+     * @brief Destructor
+     * @post The coroutine frame, if any, is destroyed
+     */
+    ~SessionTask();
+
+    SessionTask(const SessionTask&) = delete;
+    SessionTask& operator=(const SessionTask&) = delete;
+    SessionTask& operator=(SessionTask&&) = delete;
+
+    // Awaiting a task runs it and yields its result
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept;
+    bool await_resume() const noexcept;
+
+private:
+    friend class Session;
+
+    std::coroutine_handle<promise_type> handle; ///< The owned coroutine
+
+    explicit SessionTask(std::coroutine_handle<promise_type> handle);
+};
+
+/**
+ * @brief An interactive flow that awaits its input instead of blocking on it
+ *
+ * A subclass writes its dialogue as a SessionTask coroutine in run(). It
+ * prints to std::cout and reads with co_await readWord()/readLine(), which
+ * behave like `std::cin >> word` and `std::getline(std::cin, line)`. The
+ * session does not know where its input comes from: whoever owns it passes
+ * bytes to feed() as they arrive and closeInput() at end of input. A read
+ * that cannot be satisfied yet suspends the flow, so one thread can drive
+ * any number of sessions, each costing only its suspended frames and
+ * buffers. While a session runs, std::cout is redirected to its output.
+ *
+ * Sessions are not thread-safe; drive each one from a single thread.
+ */
+class Session {
+public:
+    /**
+     * @brief Constructor
+     * @param output Where the session's std::cout output goes, or nullptr to
+     *               collect it for takeOutput()
+     * @post The session is created but its flow has not started
+     */
+    explicit Session(std::streambuf* output = nullptr);
+
+    /**
+     * @brief Destructor
+     * @post Any suspended flow is destroyed without resuming
+     */
+    virtual ~Session();
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    /**
+     * @brief Starts the flow
+     * @pre start() has not been called
+     * @post The flow has run until its first unsatisfied read, or to completion
+     */
+    void start();
+
+    /**
+     * @brief Delivers input
+     * @param bytes The next bytes of input; lines end with '\n'
+     * @pre start() has been called
+     * @post The flow has run for as long as the buffered input satisfies its reads
+     */
+    void feed(const std::string& bytes);
+
+    /**
+     * @brief Marks the end of input
+     * @post Pending and later reads fail once the buffered input is used up,
+     *       so the flow runs to completion
+     */
+    void closeInput();
+
+    /**
+     * @brief Runs the session to completion, feeding it lines from a stream
+     * @param in The stream to read; each line is fed as soon as the flow waits for it
+     * @post The session is finished
+     */
+    void drive(std::istream& in);
+
+    /**
+     * @brief Checks whether the flow has completed
+     * @return True if finished, false otherwise
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief Checks whether the flow is suspended waiting for input
+     * @return True if waiting, false otherwise
+     */
+    bool isWaitingForInput() const;
+
+    /**
+     * @brief Takes the collected output
+     * @pre The session was constructed without an output buffer
+     * @return Everything printed since the last call
+     */
+    std::string takeOutput();
+
+    /**
+     * @brief Gets the bytes of coroutine frames this session has alive
+     * @return Frame bytes
+     */
+    std::size_t getFrameBytes() const;
+
+    /**
+     * @brief Gets the heap bytes this session holds: frames and buffers
+     * @return Heap bytes, not counting the session object itself
+     */
+    std::size_t getHeapBytes() const;
+
+protected:
+    /// How an awaited read consumes input
+    enum ReadMode { ReadWord, ReadLine, SkipLine };
+
+    /// Awaitable returned by the read helpers; resumes with false at end of input
+    class InputAwaiter {
+    public:
+        InputAwaiter(Session& session, ReadMode mode, std::string* target)
+            : session(session), mode(mode), target(target) {}
+        bool await_ready() const { return session.inputReady(mode); }
+        void await_suspend(std::coroutine_handle<> waiter);
+        bool await_resume() { return session.takeInput(mode, target); }
+
+    private:
+        Session& session;
+        ReadMode mode;
+        std::string* target;
+    };
+
+    /**
+     * @brief The session's flow
+     * @return The coroutine that start() runs
+     */
+    virtual SessionTask run() = 0;
+
+    /**
+     * @brief Reads a whitespace-delimited word, like `std::cin >> word`
+     * @param word Receives the word
+     * @return Awaitable yielding false if input ended first
+     */
+    InputAwaiter readWord(std::string& word);
+
+    /**
+     * @brief Reads the rest of the current line, like std::getline
+     * @param line Receives the line without its '\n' (or "\r\n")
+     * @return Awaitable yielding false if input had already ended
+     */
+    InputAwaiter readLine(std::string& line);
+
+    /**
+     * @brief Discards the rest of the current line, like `std::cin.ignore(max, '\n')`
+     * @return Awaitable yielding true
+     */
+    InputAwaiter skipLine();
+
+    /**
+     * @brief Discards one buffered character, like `std::cin.ignore()`
+     * @post The character after the last word read is consumed, if buffered
+     */
+    void skipChar();
+
+    /**
+     * @brief Checks whether input has ended and every buffered byte was read
+     * @return True at end of input, false otherwise
+     */
+    bool atEndOfInput() const;
+
+private:
+    friend struct SessionTask::promise_type;
+
+    /// Appends what the flow prints to a string owned by the session
+    class OutputBuffer : public std::streambuf {
+    public:
+        std::string text; ///< Output not yet taken
+    protected:
+        int overflow(int c) override;
+        std::streamsize xsputn(const char* data, std::streamsize count) override;
+    };
+
+    static thread_local Session* active; ///< Session whose flow is running on this thread
+
+    SessionTask flow;                   ///< Top-level coroutine from run()
+    std::coroutine_handle<> waiting;    ///< Innermost coroutine suspended on a read
+    ReadMode waitingMode;               ///< What that read needs
+    std::string input;                  ///< Buffered input
+    std::size_t inputPos;               ///< First unread byte of input
+    bool inputClosed;                   ///< closeInput() was called
+    bool started;                       ///< start() was called
+    std::streambuf* output;             ///< Destination of std::cout while running
+    OutputBuffer collected;             ///< Used when no destination was given
+    std::size_t frameBytes;             ///< Bytes of this session's live frames
+
+    /**
+     * @brief Resumes a coroutine with std::cout redirected to this session
+     * @param coroutine The coroutine to resume
+     */
+    void resume(std::coroutine_handle<> coroutine);
+
+    /**
+     * @brief Checks whether a read can complete with the buffered input
+     * @param mode The read
+     * @return True if it would not need more input
+     */
+    bool inputReady(ReadMode mode) const;
+
+    /**
+     * @brief Completes a read from the buffered input
+     * @param mode The read
+     * @param target Receives the word or line (unused for SkipLine)
+     * @return False if input ended before anything was read
+     */
+    bool takeInput(ReadMode mode, std::string* target);
+
+    /**
+     * @brief Drops input that has been read
+     */
+    void compactInput();
+};
+
+#endif // SESSION_H
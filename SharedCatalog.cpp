@@ -0,0 +1,264 @@
+#include "SharedCatalog.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const std::uint64_t SHARED_CATALOG_MAGIC = 0x474C544341433034ull;  // "40CACTLG"
+const std::uint32_t LAYOUT_VERSION = 1;
+const std::size_t HEADER_BYTES = 64;  // The header, padded so slots start on a cache line
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared counters must be lock-free");
+static_assert(sizeof(SharedCatalogHeader) <= HEADER_BYTES, "header must fit its padding");
+
+/// Start of a slot: the entry array and then the strings follow
+struct SlotHeader {
+    std::uint64_t version;  ///< Publish counter of the version in this slot
+    std::uint64_t count;    ///< Number of entries
+};
+
+std::size_t roundUp(std::size_t bytes, std::size_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+// Copies a string into the slot's string area and returns its reference
+SharedString appendString(char* slot, std::size_t& used, std::string_view text) {
+    SharedString reference{static_cast<std::uint32_t>(used), static_cast<std::uint32_t>(text.size())};
+    std::memcpy(slot + used, text.data(), text.size());
+    used += text.size();
+    return reference;
+}
+
+} // namespace
+
+// SharedProduct
+void SharedProduct::display(std::ostream& out) const {
+    out << "Product Name: " << getName() << std::endl;
+    out << "Description: " << getDescription() << std::endl;
+    out << "Rating: " << getRating() << std::endl;
+    out << "Price: $" << Product::formatPrice(getPrice()) << std::endl;
+    out << "Sold Count: " << getSoldCount() << std::endl;
+    if (isGood()) {
+        out << "Expiration Date: " << getExpirationDate() << std::endl;
+        out << "Quantity Available: " << getQuantity() << std::endl;
+    } else {
+        out << "Type: " << getType() << std::endl;
+        out << "Target Audience: " << getTargetAudience() << std::endl;
+    }
+}
+
+// SharedCatalogView
+SharedCatalogView::SharedCatalogView(const char* slot, std::size_t slotBytes)
+    : slot(slot), slotBytes(slotBytes),
+      entries(reinterpret_cast<const SharedProductEntry*>(slot + sizeof(SlotHeader))) {
+    const SlotHeader* slotHeader = reinterpret_cast<const SlotHeader*>(slot);
+    // A slot being rewritten may hold any count; never index past the slot
+    std::size_t fits = (slotBytes - sizeof(SlotHeader)) / sizeof(SharedProductEntry);
+    count = static_cast<std::size_t>(std::min<std::uint64_t>(slotHeader->count, fits));
+    version = slotHeader->version;
+}
+
+// SharedCatalogWriter
+SharedCatalogWriter::SharedCatalogWriter()
+    : region(nullptr), regionBytes(0), header(nullptr), version(0) {}
+
+SharedCatalogWriter::~SharedCatalogWriter() {
+    if (region != nullptr) {
+        munmap(region, regionBytes);
+        shm_unlink(name.c_str());
+    }
+}
+
+bool SharedCatalogWriter::create(const std::string& name, std::size_t slotBytes) {
+    slotBytes = roundUp(std::max(slotBytes, sizeof(SlotHeader)), alignof(SharedProductEntry));
+    if (slotBytes > UINT32_MAX) {
+        std::cout << "Error: A shared catalog slot is limited to 4 GB." << std::endl;
+        return false;
+    }
+    // Replace any old region; readers that still map it keep their copy
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cout << "Error: Could not create shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::size_t bytes = HEADER_BYTES + 2 * slotBytes;
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+        mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int savedErrno = errno;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cout << "Error: Could not map shared memory " << name << ": " << std::strerror(savedErrno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate zero-filled both slots, so each already holds an empty version 0
+    this->name = name;
+    region = static_cast<char*>(mapped);
+    regionBytes = bytes;
+    header = new (region) SharedCatalogHeader;
+    header->layoutVersion = LAYOUT_VERSION;
+    header->slotBytes = static_cast<std::uint32_t>(slotBytes);
+    header->active.store(0, std::memory_order_relaxed);
+    header->sequence[0].store(0, std::memory_order_relaxed);
+    header->sequence[1].store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHARED_CATALOG_MAGIC;
+    return true;
+}
+
+bool SharedCatalogWriter::publish(const Vendor& vendor) {
+    std::vector<Product*> products = vendor.getProducts();
+
+    // Size the version first, so a catalog that does not fit leaves both slots intact
+    std::size_t stringsStart = sizeof(SlotHeader) + products.size() * sizeof(SharedProductEntry);
+    std::size_t needed = stringsStart;
+    for (const Product* product : products) {
+        needed += product->getName().size() + product->getDescriptionText().size();
+        if (const Good* good = dynamic_cast<const Good*>(product)) {
+            needed += good->getExpirationDate().size();
+        } else if (const Media* media = dynamic_cast<const Media*>(product)) {
+            needed += media->getType().size() + media->getTargetAudience().size();
+        }
+    }
+    if (needed > header->slotBytes) {
+        std::cout << "Error: The catalog needs " << needed << " bytes but a shared catalog slot holds "
+                  << header->slotBytes << "." << std::endl;
+        return false;
+    }
+
+    // Write the slot readers are not directed to, bracketed by its sequence counter
+    std::uint32_t slotIndex = header->active.load(std::memory_order_relaxed) ^ 1;
+    std::uint64_t sequence = header->sequence[slotIndex].load(std::memory_order_relaxed);
+    header->sequence[slotIndex].store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    char* slot = region + HEADER_BYTES + slotIndex * static_cast<std::size_t>(header->slotBytes);
+    SharedProductEntry* entries = reinterpret_cast<SharedProductEntry*>(slot + sizeof(SlotHeader));
+    std::size_t used = stringsStart;
+    for (std::size_t i = 0; i < products.size(); i++) {
+        const Product* product = products[i];
+        SharedProductEntry& entry = entries[i];
+        entry.id = product->getId();
+        entry.price = product->getPrice();
+        entry.rating = product->getRating();
+        entry.soldCount = product->getSoldCount();
+        entry.name = appendString(slot, used, product->getName());
+        entry.description = appendString(slot, used, product->getDescription().text());
+        if (const Good* good = dynamic_cast<const Good*>(product)) {
+            entry.isGood = 1;
+            entry.quantity = good->getQuantity();
+            entry.detail = appendString(slot, used, good->getExpirationDate());
+            entry.audience = SharedString{0, 0};
+        } else {
+            const Media* media = dynamic_cast<const Media*>(product);
+            entry.isGood = 0;
+            entry.quantity = 0;
+            entry.detail = appendString(slot, used, media != nullptr ? media->getType() : std::string_view());
+            entry.audience = appendString(slot, used, media != nullptr ? media->getTargetAudience() : std::string_view());
+        }
+    }
+    SlotHeader* slotHeader = reinterpret_cast<SlotHeader*>(slot);
+    slotHeader->version = ++version;
+    slotHeader->count = products.size();
+
+    header->sequence[slotIndex].store(sequence + 2, std::memory_order_release);
+    header->active.store(slotIndex, std::memory_order_release);
+    return true;
+}
+
+// SharedCatalogReader
+SharedCatalogReader::SharedCatalogReader() : region(nullptr), regionBytes(0), header(nullptr), retries(0) {}
+
+SharedCatalogReader::~SharedCatalogReader() {
+    if (region != nullptr) {
+        munmap(region, regionBytes);
+    }
+}
+
+bool SharedCatalogReader::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cout << "Error: Could not open shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat info;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= HEADER_BYTES) {
+        mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cout << "Error: Could not map shared memory " << name << "." << std::endl;
+        return false;
+    }
+
+    const SharedCatalogHeader* mappedHeader = static_cast<const SharedCatalogHeader*>(mapped);
+    std::size_t bytes = static_cast<std::size_t>(info.st_size);
+    bool valid = mappedHeader->magic == SHARED_CATALOG_MAGIC;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && mappedHeader->layoutVersion == LAYOUT_VERSION
+        && mappedHeader->slotBytes >= sizeof(SlotHeader)
+        && bytes >= HEADER_BYTES + 2 * static_cast<std::size_t>(mappedHeader->slotBytes);
+    if (!valid) {
+        std::cout << "Error: " << name << " is not a shared catalog." << std::endl;
+        munmap(mapped, bytes);
+        return false;
+    }
+    region = static_cast<char*>(mapped);
+    regionBytes = bytes;
+    header = mappedHeader;
+    return true;
+}
+
+const char* SharedCatalogReader::slotData(std::uint32_t slot) const {
+    return region + HEADER_BYTES + slot * static_cast<std::size_t>(header->slotBytes);
+}
+
+std::size_t SharedCatalogReader::searchProducts(std::string_view text, std::vector<ProductId>& matches) const {
+    read([&](const SharedCatalogView& view) {
+        matches.clear();
+        for (std::size_t i = 0; i < view.size(); i++) {
+            SharedProduct product = view.at(i);
+            if (product.getName().find(text) != std::string_view::npos
+                || product.getDescription().find(text) != std::string_view::npos) {
+                matches.push_back(product.getId());
+            }
+        }
+    });
+    return matches.size();
+}
+
+void SharedCatalogReader::displayAllProducts(std::ostream& out) const {
+    // Rendered first and printed once consistent, so a retry never prints twice
+    std::ostringstream listing;
+    read([&](const SharedCatalogView& view) {
+        listing.str("");
+        if (view.size() == 0) {
+            listing << "You don't have any products yet." << std::endl;
+            return;
+        }
+        listing << "==== Your Products ====" << std::endl;
+        for (std::size_t i = 0; i < view.size(); i++) {
+            SharedProduct product = view.at(i);
+            listing << "Product #" << i + 1 << " (ID: " << product.getId() << "):" << std::endl;
+            product.display(listing);
+            listing << "----------------------" << std::endl;
+        }
+    });
+    out << listing.str();
+}
+
+std::uint64_t SharedCatalogReader::getRetries() const {
+    return retries.load(std::memory_order_relaxed);
+}
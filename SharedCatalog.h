@@ -0,0 +1,268 @@
+#ifndef SHARED_CATALOG_H
+#define SHARED_CATALOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Product.h"
+#include "Vendor.h"
+
+/// Reference to a string in a shared catalog slot
+struct SharedString {
+    std::uint32_t offset;  ///< Byte offset from the start of the slot
+    std::uint32_t length;  ///< Length in bytes
+};
+
+/// One product as laid out in a shared catalog slot; holds no pointers
+struct SharedProductEntry {
+    std::uint64_t id;            ///< Stable product ID
+    std::int64_t price;          ///< Unit price in cents
+    std::int32_t rating;         ///< Customer rating
+    std::int32_t soldCount;      ///< Units sold
+    std::int32_t quantity;       ///< Good quantity (0 for media)
+    std::uint32_t isGood;        ///< 1 for Good, 0 for Media
+    SharedString name;           ///< Product name
+    SharedString description;    ///< Product description
+    SharedString detail;         ///< Media type, or Good expiration date
+    SharedString audience;       ///< Media target audience (empty for goods)
+};
+
+/**
+ * @brief Read-only view of one product in a shared catalog
+ *
+ * The getters read straight from shared memory. String offsets are
+ * checked against the slot, so a view of a slot that the writer is
+ * overwriting returns garbage but never reads outside the mapping.
+ */
+class SharedProduct {
+public:
+    SharedProduct(const char* slot, std::size_t slotBytes, const SharedProductEntry* entry)
+        : slot(slot), slotBytes(slotBytes), entry(entry) {}
+
+    ProductId getId() const { return entry->id; }
+    bool isGood() const { return entry->isGood != 0; }
+    int getRating() const { return entry->rating; }
+    int getSoldCount() const { return entry->soldCount; }
+    Cents getPrice() const { return entry->price; }
+    std::string_view getName() const { return text(entry->name); }
+    std::string_view getDescription() const { return text(entry->description); }
+    std::string_view getType() const { return isGood() ? std::string_view() : text(entry->detail); }
+    std::string_view getTargetAudience() const { return text(entry->audience); }
+    std::string_view getExpirationDate() const { return isGood() ? text(entry->detail) : std::string_view(); }
+    int getQuantity() const { return entry->quantity; }
+
+    /**
+     * @brief Prints the product in the same layout as Product::display()
+     * @param out The stream to print to
+     */
+    void display(std::ostream& out) const;
+
+private:
+    const char* slot;                  ///< Start of the slot
+    std::size_t slotBytes;             ///< Size of the slot
+    const SharedProductEntry* entry;   ///< The product's entry in the slot
+
+    std::string_view text(SharedString reference) const {
+        if (reference.offset > slotBytes || reference.length > slotBytes - reference.offset) {
+            return std::string_view();
+        }
+        return std::string_view(slot + reference.offset, reference.length);
+    }
+};
+
+/**
+ * @brief Read-only view of one published catalog version
+ */
+class SharedCatalogView {
+public:
+    SharedCatalogView(const char* slot, std::size_t slotBytes);
+
+    /**
+     * @brief Gets the number of products in this version
+     * @return The product count
+     */
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief Gets the product at a position in catalog order
+     * @param index The position, below size()
+     * @return A view of the product
+     */
+    SharedProduct at(std::size_t index) const {
+        return SharedProduct(slot, slotBytes, entries + index);
+    }
+
+    /**
+     * @brief Gets the publish counter of this version
+     * @return The version, incremented by every publish
+     */
+    std::uint64_t getVersion() const { return version; }
+
+private:
+    const char* slot;                   ///< Start of the slot
+    std::size_t slotBytes;              ///< Size of the slot
+    const SharedProductEntry* entries;  ///< Entry array at the start of the slot's data
+    std::size_t count;                  ///< Entries, clamped to what fits in the slot
+    std::uint64_t version;              ///< Publish counter
+};
+
+/// Header at the start of a shared catalog region
+struct SharedCatalogHeader {
+    std::uint64_t magic;                       ///< SHARED_CATALOG_MAGIC once initialized
+    std::uint32_t layoutVersion;               ///< Layout of the structures in this file
+    std::uint32_t slotBytes;                   ///< Size of each of the two slots
+    std::atomic<std::uint32_t> active;         ///< Slot holding the latest complete version
+    std::atomic<std::uint64_t> sequence[2];    ///< Per-slot seqlock counter; odd while the slot is written
+};
+
+/**
+ * @brief Publishes a vendor's catalog into POSIX shared memory
+ *
+ * The region holds a header and two slots. Each slot is a flat array of
+ * SharedProductEntry records followed by their strings, addressed by
+ * offsets from the slot, so any process can map it at any address.
+ * publish() rewrites the slot readers are not directed to and then flips
+ * the active slot, so it never waits for readers; each slot's sequence
+ * counter is odd while it is being written. Only one process may write.
+ */
+class SharedCatalogWriter {
+public:
+    /**
+     * @brief Default constructor
+     * @post No region is open
+     */
+    SharedCatalogWriter();
+
+    /**
+     * @brief Destructor
+     * @post The region is unmapped and its name removed; mapped readers keep their view
+     */
+    ~SharedCatalogWriter();
+
+    SharedCatalogWriter(const SharedCatalogWriter&) = delete;
+    SharedCatalogWriter& operator=(const SharedCatalogWriter&) = delete;
+
+    /**
+     * @brief Creates the shared memory region
+     * @param name The shared memory name, starting with '/'; an existing region with this name is replaced
+     * @param slotBytes Room for one catalog version (entries plus strings)
+     * @pre No region is open
+     * @return True if created, false otherwise (an error is printed)
+     */
+    bool create(const std::string& name, std::size_t slotBytes);
+
+    /**
+     * @brief Publishes the vendor's current products in catalog order
+     * @param vendor The vendor
+     * @pre create() succeeded
+     * @post Readers that start a query after this returns see the new version
+     * @return True if published, false if the catalog does not fit in a slot (an error is printed)
+     */
+    bool publish(const Vendor& vendor);
+
+private:
+    std::string name;              ///< Shared memory name
+    char* region;                  ///< Mapped region (nullptr if none)
+    std::size_t regionBytes;       ///< Size of the mapping
+    SharedCatalogHeader* header;   ///< Header at the start of the region
+    std::uint64_t version;         ///< Publish counter
+};
+
+/**
+ * @brief Maps a shared catalog read-only and answers queries from it
+ *
+ * Queries run directly on the mapped memory with no system calls or
+ * locks. A query reads the slot's sequence counter, runs, and reads it
+ * again; if the writer reused the slot in the meantime, the query is
+ * retried. That needs two publishes during one query, so retries are rare.
+ */
+class SharedCatalogReader {
+public:
+    /**
+     * @brief Default constructor
+     * @post No region is open
+     */
+    SharedCatalogReader();
+
+    /**
+     * @brief Destructor
+     * @post The region is unmapped
+     */
+    ~SharedCatalogReader();
+
+    SharedCatalogReader(const SharedCatalogReader&) = delete;
+    SharedCatalogReader& operator=(const SharedCatalogReader&) = delete;
+
+    /**
+     * @brief Maps a region created by a SharedCatalogWriter
+     * @param name The shared memory name
+     * @pre No region is open
+     * @return True if mapped, false otherwise (an error is printed)
+     */
+    bool open(const std::string& name);
+
+    /**
+     * @brief Runs fn(const SharedCatalogView&) against one consistent version
+     * @param fn The query; may run more than once, so it must reset any results it collects
+     * @pre open() succeeded
+     * @return The version fn's last run saw
+     */
+    template<class Fn>
+    std::uint64_t read(Fn fn) const {
+        while (true) {
+            std::uint32_t slot = header->active.load(std::memory_order_acquire) & 1;
+            std::uint64_t before = header->sequence[slot].load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                SharedCatalogView view(slotData(slot), header->slotBytes);
+                fn(view);
+                // Orders the query's reads before the check (seqlock reader)
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (header->sequence[slot].load(std::memory_order_relaxed) == before) {
+                    return view.getVersion();
+                }
+            }
+            retries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Finds the products whose name or description contains some text
+     * @param text The text to look for (case-sensitive); empty text matches every product
+     * @param matches Cleared, then filled with the IDs of the matching products in catalog order
+     * @pre open() succeeded
+     * @return The number of matches
+     */
+    std::size_t searchProducts(std::string_view text, std::vector<ProductId>& matches) const;
+
+    /**
+     * @brief Prints every product in catalog order, as Vendor::displayAllProducts() does
+     * @param out The stream to print to
+     * @pre open() succeeded
+     */
+    void displayAllProducts(std::ostream& out = std::cout) const;
+
+    /**
+     * @brief Gets the number of queries that had to be rerun
+     * @return The retry count
+     */
+    std::uint64_t getRetries() const;
+
+private:
+    char* region;                             ///< Mapped region (nullptr if none)
+    std::size_t regionBytes;                  ///< Size of the mapping
+    const SharedCatalogHeader* header;        ///< Header at the start of the region
+    mutable std::atomic<std::uint64_t> retries; ///< Queries rerun after a concurrent publish
+
+    /**
+     * @brief Gets the start of a slot
+     * @param slot 0 or 1
+     * @return The slot's first byte
+     */
+    const char* slotData(std::uint32_t slot) const;
+};
+
+#endif // SHARED_CATALOG_H
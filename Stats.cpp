@@ -0,0 +1,265 @@
+#include "Stats.h"
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+const int Stats::BUCKET_COUNT;
+
+namespace {
+
+const int OP_COUNT = static_cast<int>(StatsOp::Count);
+const int COUNTER_COUNT = static_cast<int>(StatsCounter::Count);
+
+// One thread's counters. Only the owning thread writes; readers load
+// relaxed values while merging, so a summary may miss in-flight calls.
+struct StatsShard {
+    std::atomic<std::uint64_t> count[OP_COUNT];
+    std::atomic<std::uint64_t> totalNanos[OP_COUNT];
+    std::atomic<std::uint64_t> maxNanos[OP_COUNT];
+    std::atomic<std::uint64_t> buckets[OP_COUNT][Stats::BUCKET_COUNT];
+    std::atomic<std::uint64_t> events[COUNTER_COUNT];
+
+    StatsShard() { clear(); }
+
+    void clear() {
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            events[c].store(0, std::memory_order_relaxed);
+        }
+        for (int op = 0; op < OP_COUNT; op++) {
+            count[op].store(0, std::memory_order_relaxed);
+            totalNanos[op].store(0, std::memory_order_relaxed);
+            maxNanos[op].store(0, std::memory_order_relaxed);
+            for (int b = 0; b < Stats::BUCKET_COUNT; b++) {
+                buckets[op][b].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Adds another shard's values into this one (used when a thread exits)
+    void absorb(const StatsShard& other) {
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            events[c].fetch_add(other.events[c].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        for (int op = 0; op < OP_COUNT; op++) {
+            count[op].fetch_add(other.count[op].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            totalNanos[op].fetch_add(other.totalNanos[op].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            std::uint64_t otherMax = other.maxNanos[op].load(std::memory_order_relaxed);
+            if (otherMax > maxNanos[op].load(std::memory_order_relaxed)) {
+                maxNanos[op].store(otherMax, std::memory_order_relaxed);
+            }
+            for (int b = 0; b < Stats::BUCKET_COUNT; b++) {
+                buckets[op][b].fetch_add(other.buckets[op][b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Live shards plus the folded-in totals of threads that already exited
+struct StatsRegistry {
+    std::mutex lock;
+    std::vector<StatsShard*> shards;
+    StatsShard retired;
+};
+
+StatsRegistry& registry() {
+    // Leaked on purpose so thread-exit handlers never see a destroyed registry
+    static StatsRegistry* instance = new StatsRegistry();
+    return *instance;
+}
+
+// Registers the calling thread's shard on first use and retires it on exit
+struct StatsShardHandle {
+    StatsShard* shard;
+
+    StatsShardHandle() : shard(new StatsShard()) {
+        StatsRegistry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        reg.shards.push_back(shard);
+    }
+
+    ~StatsShardHandle() {
+        StatsRegistry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        reg.retired.absorb(*shard);
+        for (size_t i = 0; i < reg.shards.size(); i++) {
+            if (reg.shards[i] == shard) {
+                reg.shards[i] = reg.shards.back();
+                reg.shards.pop_back();
+                break;
+            }
+        }
+        delete shard;
+    }
+};
+
+StatsShard& localShard() {
+    thread_local StatsShardHandle handle;
+    return *handle.shard;
+}
+
+// Returns the upper bound of the bucket holding the given rank (1-based)
+std::uint64_t valueAtRank(const std::vector<std::uint64_t>& buckets, std::uint64_t rank) {
+    std::uint64_t seen = 0;
+    for (int b = 0; b < Stats::BUCKET_COUNT; b++) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return Stats::bucketUpperBound(b);
+        }
+    }
+    return 0;
+}
+
+std::uint64_t rankFor(std::uint64_t count, int perThousand) {
+    // Nearest-rank percentile: ceil(count * p)
+    std::uint64_t rank = (count * perThousand + 999) / 1000;
+    return rank == 0 ? 1 : rank;
+}
+
+} // namespace
+
+int Stats::bucketFor(std::uint64_t nanos) {
+    if (nanos < 16) {
+        return static_cast<int>(nanos);
+    }
+    int msb = 63;
+    while ((nanos >> msb) == 0) {
+        msb--;
+    }
+    int sub = static_cast<int>((nanos >> (msb - 2)) & 3);
+    return 16 + (msb - 4) * 4 + sub;
+}
+
+std::uint64_t Stats::bucketUpperBound(int bucket) {
+    if (bucket < 16) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    int msb = (bucket - 16) / 4 + 4;
+    std::uint64_t sub = static_cast<std::uint64_t>((bucket - 16) % 4);
+    std::uint64_t width = std::uint64_t(1) << (msb - 2);
+    return (std::uint64_t(1) << msb) + (sub + 1) * width - 1;
+}
+
+void Stats::record(StatsOp op, std::uint64_t nanos) {
+    StatsShard& shard = localShard();
+    int i = static_cast<int>(op);
+    // Single writer per shard, so plain load/store pairs are enough
+    shard.count[i].store(shard.count[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    shard.totalNanos[i].store(shard.totalNanos[i].load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+    if (nanos > shard.maxNanos[i].load(std::memory_order_relaxed)) {
+        shard.maxNanos[i].store(nanos, std::memory_order_relaxed);
+    }
+    std::atomic<std::uint64_t>& bucket = shard.buckets[i][bucketFor(nanos)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Stats::increment(StatsCounter counter) {
+    std::atomic<std::uint64_t>& event = localShard().events[static_cast<int>(counter)];
+    event.store(event.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+std::uint64_t Stats::total(StatsCounter counter) {
+    int c = static_cast<int>(counter);
+    StatsRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    std::uint64_t sum = reg.retired.events[c].load(std::memory_order_relaxed);
+    for (const StatsShard* shard : reg.shards) {
+        sum += shard->events[c].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+StatsSummary Stats::summarize(StatsOp op) {
+    int i = static_cast<int>(op);
+    StatsSummary summary = {0, 0, 0, 0, 0, 0};
+    std::vector<std::uint64_t> merged(BUCKET_COUNT, 0);
+
+    StatsRegistry& reg = registry();
+    {
+        std::lock_guard<std::mutex> guard(reg.lock);
+        std::vector<const StatsShard*> all(reg.shards.begin(), reg.shards.end());
+        all.push_back(&reg.retired);
+        for (const StatsShard* shard : all) {
+            summary.count += shard->count[i].load(std::memory_order_relaxed);
+            summary.totalNanos += shard->totalNanos[i].load(std::memory_order_relaxed);
+            std::uint64_t shardMax = shard->maxNanos[i].load(std::memory_order_relaxed);
+            if (shardMax > summary.maxNanos) {
+                summary.maxNanos = shardMax;
+            }
+            for (int b = 0; b < BUCKET_COUNT; b++) {
+                merged[b] += shard->buckets[i][b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Recount from the buckets so percentiles agree with a torn count read
+    std::uint64_t bucketTotal = 0;
+    for (std::uint64_t n : merged) {
+        bucketTotal += n;
+    }
+    if (bucketTotal > 0) {
+        summary.p50Nanos = valueAtRank(merged, rankFor(bucketTotal, 500));
+        summary.p99Nanos = valueAtRank(merged, rankFor(bucketTotal, 990));
+        summary.p999Nanos = valueAtRank(merged, rankFor(bucketTotal, 999));
+        // A bucket bound can overshoot the largest sample it holds
+        if (summary.p50Nanos > summary.maxNanos) summary.p50Nanos = summary.maxNanos;
+        if (summary.p99Nanos > summary.maxNanos) summary.p99Nanos = summary.maxNanos;
+        if (summary.p999Nanos > summary.maxNanos) summary.p999Nanos = summary.maxNanos;
+    }
+    return summary;
+}
+
+void Stats::reset() {
+    StatsRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (StatsShard* shard : reg.shards) {
+        shard->clear();
+    }
+    reg.retired.clear();
+}
+
+void Stats::dump(std::ostream& out) {
+    out << "==== Operation Statistics ====" << std::endl;
+#ifdef AMAZON340_DISABLE_STATS
+    out << "(statistics were compiled out of this build)" << std::endl;
+#endif
+    out << std::left << std::setw(16) << "Operation"
+        << std::right << std::setw(10) << "Count"
+        << std::setw(12) << "Mean(ns)"
+        << std::setw(12) << "p50(ns)"
+        << std::setw(12) << "p99(ns)"
+        << std::setw(12) << "p999(ns)"
+        << std::setw(12) << "Max(ns)" << std::endl;
+    for (int i = 0; i < OP_COUNT; i++) {
+        StatsOp op = static_cast<StatsOp>(i);
+        StatsSummary s = summarize(op);
+        std::uint64_t mean = s.count == 0 ? 0 : s.totalNanos / s.count;
+        out << std::left << std::setw(16) << opName(op)
+            << std::right << std::setw(10) << s.count
+            << std::setw(12) << mean
+            << std::setw(12) << s.p50Nanos
+            << std::setw(12) << s.p99Nanos
+            << std::setw(12) << s.p999Nanos
+            << std::setw(12) << s.maxNanos << std::endl;
+    }
+
+    std::uint64_t hits = total(StatsCounter::RenderHit);
+    std::uint64_t misses = total(StatsCounter::RenderMiss);
+    out << "Render cache: " << hits << " hits, " << misses << " misses";
+    if (hits + misses > 0) {
+        out << " (" << std::fixed << std::setprecision(1) << 100.0 * hits / (hits + misses) << "% hit ratio)";
+        out.unsetf(std::ios::floatfield);
+        out << std::setprecision(6);
+    }
+    out << std::endl;
+}
+
+const char* Stats::opName(StatsOp op) {
+    switch (op) {
+        case StatsOp::SellProduct:   return "sellProduct";
+        case StatsOp::GetKthProduct: return "getKthProduct";
+        case StatsOp::CreateProduct: return "createProduct";
+        case StatsOp::DeleteProduct: return "deleteProduct";
+        default:                     return "unknown";
+    }
+}
@@ -0,0 +1,164 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+/**
+ * @brief Operations whose call counts and latencies are recorded
+ */
+enum class StatsOp {
+    SellProduct,    ///< Vendor::sellProduct
+    GetKthProduct,  ///< Vendor::getKthProduct
+    CreateProduct,  ///< Vendor::createProduct
+    DeleteProduct,  ///< Vendor::deleteProduct
+    Count           ///< Number of tracked operations (not an operation)
+};
+
+/**
+ * @brief Events that are counted but not timed
+ */
+enum class StatsCounter {
+    RenderHit,      ///< Product::display served from the render cache
+    RenderMiss,     ///< Product::display rendered the product
+    Count           ///< Number of tracked counters (not a counter)
+};
+
+/**
+ * @brief Merged latency summary for one operation
+ */
+struct StatsSummary {
+    std::uint64_t count;       ///< Number of recorded calls
+    std::uint64_t totalNanos;  ///< Sum of all recorded latencies
+    std::uint64_t maxNanos;    ///< Largest recorded latency
+    std::uint64_t p50Nanos;    ///< Median latency (bucket upper bound)
+    std::uint64_t p99Nanos;    ///< 99th percentile latency (bucket upper bound)
+    std::uint64_t p999Nanos;   ///< 99.9th percentile latency (bucket upper bound)
+};
+
+/**
+ * @brief Per-operation counters and log-bucketed latency histograms
+ *
+ * Each thread records into its own shard, so the hot path is a handful of
+ * relaxed atomic increments with no sharing between threads. Shards are
+ * merged only when a summary is read. Building with AMAZON340_DISABLE_STATS
+ * defined compiles every recording site out; the read side then reports
+ * empty summaries.
+ */
+class Stats {
+public:
+    /// Number of histogram buckets: 16 linear ones, then 4 per power of two
+    static const int BUCKET_COUNT = 256;
+
+    /**
+     * @brief Records one call of an operation
+     * @param op The operation that ran
+     * @param nanos How long the call took, in nanoseconds
+     * @pre None
+     * @post The calling thread's shard reflects the call
+     */
+    static void record(StatsOp op, std::uint64_t nanos);
+    
+    /**
+     * @brief Counts one occurrence of an event
+     * @param counter The event
+     * @pre None
+     * @post The calling thread's shard reflects the event
+     */
+    static void increment(StatsCounter counter);
+    
+    /**
+     * @brief Merges all shards into a total for one counter
+     * @param counter The event
+     * @return The number of occurrences recorded
+     */
+    static std::uint64_t total(StatsCounter counter);
+
+    /**
+     * @brief Merges all shards into a summary for one operation
+     * @param op The operation to summarize
+     * @return The merged summary
+     */
+    static StatsSummary summarize(StatsOp op);
+
+    /**
+     * @brief Clears every shard
+     * @pre No other thread is recording
+     * @post All counters and histograms are zero
+     */
+    static void reset();
+
+    /**
+     * @brief Prints count and p50/p99/p999 latency for every operation, then the cache hit ratios
+     * @param out The stream to print to
+     * @pre None
+     * @post The statistics table is written to out
+     */
+    static void dump(std::ostream& out = std::cout);
+
+    /**
+     * @brief Gets the display name of an operation
+     * @param op The operation
+     * @return The operation name as a C string
+     */
+    static const char* opName(StatsOp op);
+
+    /**
+     * @brief Maps a latency to its histogram bucket
+     * @param nanos The latency in nanoseconds
+     * @return The bucket index in [0, BUCKET_COUNT)
+     */
+    static int bucketFor(std::uint64_t nanos);
+
+    /**
+     * @brief Gets the largest latency that falls into a bucket
+     * @param bucket The bucket index
+     * @return The inclusive upper bound of the bucket, in nanoseconds
+     */
+    static std::uint64_t bucketUpperBound(int bucket);
+};
+
+/**
+ * @brief Records the lifetime of a scope as one call of an operation
+ */
+class StatsScopedTimer {
+private:
+    StatsOp op;                                          ///< Operation being timed
+    std::chrono::steady_clock::time_point start;         ///< Time the scope was entered
+
+public:
+    /**
+     * @brief Starts timing
+     * @param op The operation the enclosing scope implements
+     */
+    explicit StatsScopedTimer(StatsOp op)
+        : op(op), start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Stops timing and records the elapsed time
+     */
+    ~StatsScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        Stats::record(op, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    StatsScopedTimer(const StatsScopedTimer&) = delete;
+    StatsScopedTimer& operator=(const StatsScopedTimer&) = delete;
+};
+
+#define STATS_CONCAT_INNER(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_INNER(a, b)
+
+#ifndef AMAZON340_DISABLE_STATS
+/// Times the rest of the enclosing scope as one call of StatsOp::op
+#define STATS_SCOPE(op) StatsScopedTimer STATS_CONCAT(statsTimer_, __LINE__)(StatsOp::op)
+/// Counts one StatsCounter::counter event
+#define STATS_COUNT(counter) Stats::increment(StatsCounter::counter)
+#else
+#define STATS_SCOPE(op) ((void)0)
+#define STATS_COUNT(counter) ((void)0)
+#endif
+
+#endif // STATS_H
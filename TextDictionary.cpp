@@ -0,0 +1,289 @@
+#include "TextDictionary.h"
+#include <algorithm>
+#include <cstring>
+
+const std::size_t TextDictionary::MAX_SIZE;
+const int TextDictionary::HASH_BITS;
+const int TextDictionary::MIN_MATCH;
+const int TextDictionary::MAX_CHAIN;
+
+namespace {
+
+const std::size_t KMER = 8;                 // Phrase fragment length scored by train()
+const std::size_t SEGMENT = 64;             // Bytes train() copies into the dictionary at a time
+const int FREQUENCY_BITS = 20;              // log2 of train()'s k-mer counter table
+const std::size_t SAMPLE_LIMIT = 8 << 20;   // Sample bytes train() looks at
+const int LOCAL_BITS = 10;                  // log2 of compress()'s table for the text itself
+const std::size_t MAX_DISTANCE = 65535;     // Farthest back-reference
+
+std::size_t kmerSlot(const char* bytes) {
+    std::uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return static_cast<std::size_t>((value * 0x9E3779B97F4A7C15ull) >> (64 - FREQUENCY_BITS));
+}
+
+std::uint32_t hashBits(const char* bytes, int bits) {
+    std::uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return (value * 2654435761u) >> (32 - bits);
+}
+
+// Appends the part of a length that did not fit its 4-bit token field
+void writeLength(std::string& block, std::size_t extra) {
+    while (extra >= 255) {
+        block += static_cast<char>(255);
+        extra -= 255;
+    }
+    block += static_cast<char>(extra);
+}
+
+bool readLength(const unsigned char*& in, const unsigned char* end, std::size_t& length) {
+    unsigned char byte;
+    do {
+        if (in >= end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Appends one sequence: literals, then (unless last) a back-reference
+void writeSequence(std::string& block, std::string_view literals, std::size_t distance, std::size_t matchLength,
+                   bool last) {
+    std::size_t literalCount = literals.size();
+    std::size_t matchExtra = last ? 0 : matchLength - 4;
+    block += static_cast<char>((std::min<std::size_t>(literalCount, 15) << 4) | std::min<std::size_t>(matchExtra, 15));
+    if (literalCount >= 15) {
+        writeLength(block, literalCount - 15);
+    }
+    block.append(literals.data(), literals.size());
+    if (last) {
+        return;
+    }
+    block += static_cast<char>(distance & 0xFF);
+    block += static_cast<char>(distance >> 8);
+    if (matchExtra >= 15) {
+        writeLength(block, matchExtra - 15);
+    }
+}
+
+// Scores the best SEGMENT-byte window of a sample by the counts of its k-mers
+struct Segment {
+    std::size_t score = 0;
+    std::string_view bytes;
+};
+
+void scoreSample(std::string_view sample, const std::vector<std::uint32_t>& frequency, Segment& best) {
+    if (sample.size() < KMER) {
+        return;
+    }
+    std::size_t length = std::min(SEGMENT, sample.size());
+    std::size_t kmers = length - KMER + 1;
+    std::size_t score = 0;
+    for (std::size_t i = 0; i < kmers; i++) {
+        score += frequency[kmerSlot(sample.data() + i)];
+    }
+    std::size_t start = 0;
+    while (true) {
+        if (score > best.score) {
+            best.score = score;
+            best.bytes = sample.substr(start, length);
+        }
+        if (start + length >= sample.size()) {
+            break;
+        }
+        // Slide the window one byte
+        score -= frequency[kmerSlot(sample.data() + start)];
+        score += frequency[kmerSlot(sample.data() + start + kmers)];
+        start++;
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const TextDictionary> TextDictionary::train(const std::vector<std::string_view>& samples,
+                                                            std::size_t size) {
+    size = std::min(size, MAX_SIZE);
+
+    // Count every k-mer; collisions in the table only blur the scores
+    std::vector<std::uint32_t> frequency(std::size_t(1) << FREQUENCY_BITS, 0);
+    std::size_t used = 0;
+    std::size_t sampleCount = 0;
+    while (sampleCount < samples.size() && used < SAMPLE_LIMIT) {
+        std::string_view sample = samples[sampleCount++];
+        for (std::size_t i = 0; i + KMER <= sample.size(); i++) {
+            std::uint32_t& count = frequency[kmerSlot(sample.data() + i)];
+            if (count != UINT32_MAX) {
+                count++;
+            }
+        }
+        used += sample.size();
+    }
+
+    // One segment per epoch, so the scan stays linear in the sample size.
+    // Each chosen segment's k-mers stop counting, so later epochs pick other phrases.
+    std::size_t epochs = std::max<std::size_t>(1, size / SEGMENT);
+    std::size_t epochBytes = std::max<std::size_t>(1, used / epochs);
+    std::string content;
+    Segment best;
+    std::size_t epochUsed = 0;
+    for (std::size_t s = 0; s < sampleCount && content.size() < size; s++) {
+        scoreSample(samples[s], frequency, best);
+        epochUsed += samples[s].size();
+        if (epochUsed < epochBytes && s + 1 < sampleCount) {
+            continue;
+        }
+        if (best.score > 0) {
+            std::string_view chosen = best.bytes.substr(0, size - content.size());
+            content.append(chosen.data(), chosen.size());
+            for (std::size_t i = 0; i + KMER <= best.bytes.size(); i++) {
+                frequency[kmerSlot(best.bytes.data() + i)] = 0;
+            }
+        }
+        best = Segment();
+        epochUsed = 0;
+    }
+    return std::make_shared<const TextDictionary>(content);
+}
+
+TextDictionary::TextDictionary(std::string_view content)
+    : content(content.substr(0, MAX_SIZE)), head(std::size_t(1) << HASH_BITS, -1),
+      previous(this->content.size(), -1) {
+    for (std::size_t i = 0; i + MIN_MATCH <= this->content.size(); i++) {
+        std::uint32_t h = hash(this->content.data() + i);
+        previous[i] = head[h];
+        head[h] = static_cast<std::int32_t>(i);
+    }
+}
+
+std::size_t TextDictionary::size() const {
+    return content.size();
+}
+
+std::uint32_t TextDictionary::hash(const char* bytes) {
+    return hashBits(bytes, HASH_BITS);
+}
+
+void TextDictionary::compress(std::string_view text, std::string& block) const {
+    block.clear();
+    block.reserve(text.size() / 2 + 16);
+    const char* data = text.data();
+    std::size_t n = text.size();
+    std::size_t dictionarySize = content.size();
+    std::int32_t localHead[std::size_t(1) << LOCAL_BITS];
+    std::fill(localHead, localHead + (std::size_t(1) << LOCAL_BITS), -1);
+    std::vector<std::int32_t> localPrevious(n, -1);
+
+    std::size_t anchor = 0;
+    std::size_t i = 0;
+    while (i + MIN_MATCH <= n) {
+        std::size_t bestLength = 0;
+        std::size_t bestDistance = 0;
+
+        // Earlier in the text itself (may overlap the current position)
+        std::uint32_t h = hashBits(data + i, LOCAL_BITS);
+        std::int32_t candidate = localHead[h];
+        for (int tries = 0; candidate >= 0 && tries < MAX_CHAIN; tries++) {
+            std::size_t distance = i - static_cast<std::size_t>(candidate);
+            if (distance > MAX_DISTANCE) {
+                break;
+            }
+            std::size_t length = 0;
+            while (i + length < n && data[candidate + length] == data[i + length]) {
+                length++;
+            }
+            if (length > bestLength) {
+                bestLength = length;
+                bestDistance = distance;
+            }
+            candidate = localPrevious[candidate];
+        }
+
+        // In the dictionary, which sits just before the text
+        candidate = head[hash(data + i)];
+        for (int tries = 0; candidate >= 0 && tries < MAX_CHAIN; tries++) {
+            std::size_t distance = dictionarySize - static_cast<std::size_t>(candidate) + i;
+            if (distance > MAX_DISTANCE) {
+                break;
+            }
+            std::size_t limit = std::min(n - i, dictionarySize - static_cast<std::size_t>(candidate));
+            std::size_t length = 0;
+            while (length < limit && content[candidate + length] == data[i + length]) {
+                length++;
+            }
+            if (length > bestLength) {
+                bestLength = length;
+                bestDistance = distance;
+            }
+            candidate = previous[candidate];
+        }
+
+        std::size_t advance = (bestLength >= static_cast<std::size_t>(MIN_MATCH)) ? bestLength : 1;
+        for (std::size_t p = i; p < i + advance && p + MIN_MATCH <= n; p++) {
+            std::uint32_t slot = hashBits(data + p, LOCAL_BITS);
+            localPrevious[p] = localHead[slot];
+            localHead[slot] = static_cast<std::int32_t>(p);
+        }
+        if (advance > 1) {
+            writeSequence(block, text.substr(anchor, i - anchor), bestDistance, bestLength, false);
+            anchor = i + advance;
+        }
+        i += advance;
+    }
+    writeSequence(block, text.substr(anchor), 0, 0, true);
+}
+
+bool TextDictionary::decompress(std::string_view block, char* text, std::size_t length) const {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(block.data());
+    const unsigned char* end = in + block.size();
+    std::size_t dictionarySize = content.size();
+    std::size_t out = 0;
+    while (in < end) {
+        unsigned char token = *in++;
+        std::size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(in, end, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<std::size_t>(end - in) || literalCount > length - out) {
+            return false;
+        }
+        std::memcpy(text + out, in, literalCount);
+        in += literalCount;
+        out += literalCount;
+        if (in == end) {
+            return out == length;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        std::size_t distance = in[0] | (static_cast<std::size_t>(in[1]) << 8);
+        in += 2;
+        std::size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (distance == 0 || distance > out + dictionarySize || matchLength > length - out) {
+            return false;
+        }
+
+        if (distance > out && distance - out >= matchLength) {
+            // Entirely inside the dictionary
+            std::memcpy(text + out, content.data() + dictionarySize - (distance - out), matchLength);
+        } else if (distance <= out && distance >= matchLength) {
+            std::memcpy(text + out, text + out - distance, matchLength);
+        } else {
+            // Overlapping, or crossing from the dictionary into the text: byte by byte
+            for (std::size_t k = 0; k < matchLength; k++) {
+                std::size_t position = out + k;
+                text[position] = (distance > position) ? content[dictionarySize - (distance - position)]
+                                                       : text[position - distance];
+            }
+        }
+        out += matchLength;
+    }
+    return out == length && length == 0;
+}
@@ -0,0 +1,82 @@
+#ifndef TEXT_DICTIONARY_H
+#define TEXT_DICTIONARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Shared dictionary for compressing many short, similar texts
+ *
+ * Texts such as product descriptions repeat the same boilerplate, so each
+ * one compresses poorly alone but well against a dictionary of the common
+ * phrases. train() picks the phrases from sample texts. compress() then
+ * encodes a text as literals and back-references (LZ77, in an LZ4-style
+ * byte format) into the dictionary or the text itself. decompress() only
+ * copies bytes, so it runs an order of magnitude faster than compress(). A dictionary is
+ * immutable once built and may be used from any thread.
+ */
+class TextDictionary {
+public:
+    /// Largest dictionary; back-references are 16-bit offsets
+    static const std::size_t MAX_SIZE = 32768;
+
+    /**
+     * @brief Builds a dictionary from the phrases most common across the samples
+     * @param samples Texts like the ones that will be compressed
+     * @param size The dictionary size in bytes, at most MAX_SIZE
+     * @return The dictionary; smaller than size if the samples are small
+     */
+    static std::shared_ptr<const TextDictionary> train(const std::vector<std::string_view>& samples,
+                                                       std::size_t size);
+
+    /**
+     * @brief Parameterized constructor
+     * @param content The dictionary bytes (truncated to MAX_SIZE)
+     * @post The dictionary is indexed and ready to compress with
+     */
+    explicit TextDictionary(std::string_view content);
+
+    /**
+     * @brief Gets the dictionary size
+     * @return The number of dictionary bytes
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Compresses one text
+     * @param text The text
+     * @param block Replaced by the compressed block
+     */
+    void compress(std::string_view text, std::string& block) const;
+
+    /**
+     * @brief Decompresses one block
+     * @param block The compressed block
+     * @param text Receives the text; must have room for exactly length characters
+     * @param length The length of the original text
+     * @return True on success, false if the block is corrupt or does not decode to length characters
+     */
+    bool decompress(std::string_view block, char* text, std::size_t length) const;
+
+private:
+    static const int HASH_BITS = 13;    ///< log2 of the hash table size
+    static const int MIN_MATCH = 4;     ///< Shortest back-reference worth encoding
+    static const int MAX_CHAIN = 16;    ///< Candidates tried per position
+
+    std::string content;                ///< The dictionary bytes
+    std::vector<std::int32_t> head;     ///< Latest dictionary position per 4-byte hash (-1: none)
+    std::vector<std::int32_t> previous; ///< Earlier dictionary position with the same hash (-1: none)
+
+    /**
+     * @brief Hashes the 4 bytes at a position
+     * @param bytes At least MIN_MATCH readable bytes
+     * @return A hash of HASH_BITS bits
+     */
+    static std::uint32_t hash(const char* bytes);
+};
+
+#endif // TEXT_DICTIONARY_H
@@ -0,0 +1,165 @@
+#include "ThreadPool.h"
+
+namespace {
+
+// Index of the pool worker running on this thread, or -1 for outside threads
+thread_local int currentWorker = -1;
+thread_local const ThreadPool* currentPool = nullptr;
+
+} // namespace
+
+// Constructor - start one worker per deque
+ThreadPool::ThreadPool(int threadCount)
+    : queuedTasks(0), nextExternalQueue(0), stopping(false) {
+    int count = threadCount > 0 ? threadCount : static_cast<int>(std::thread::hardware_concurrency());
+    if (count <= 0) {
+        count = 1;
+    }
+    for (int i = 0; i < count; i++) {
+        queues.emplace_back(new WorkerQueue());
+    }
+    for (int i = 0; i < count; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+// Destructor - wake and join every worker
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::getThreadCount() const {
+    return static_cast<int>(workers.size());
+}
+
+// Scheduling
+void ThreadPool::push(Task task) {
+    std::size_t target;
+    if (currentPool == this && currentWorker >= 0) {
+        target = static_cast<std::size_t>(currentWorker);
+    } else {
+        target = nextExternalQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    }
+    {
+        std::lock_guard<std::mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    queuedTasks.fetch_add(1, std::memory_order_release);
+    {
+        // Taking the lock orders this notify after any sleeper's predicate check
+        std::lock_guard<std::mutex> guard(sleepLock);
+    }
+    wakeUp.notify_one();
+}
+
+bool ThreadPool::tryRunOne() {
+    std::size_t count = queues.size();
+    std::size_t self = (currentPool == this && currentWorker >= 0)
+        ? static_cast<std::size_t>(currentWorker) : count;
+    Task task;
+
+    // Own deque, newest first
+    if (self < count) {
+        std::lock_guard<std::mutex> guard(queues[self]->lock);
+        if (!queues[self]->tasks.empty()) {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+        }
+    }
+
+    // Steal the oldest (largest) task from another deque
+    if (!task) {
+        std::size_t start = self < count ? self + 1 : 0;
+        for (std::size_t n = 0; n < count && !task; n++) {
+            std::size_t victim = (start + n) % count;
+            if (victim == self) {
+                continue;
+            }
+            std::lock_guard<std::mutex> guard(queues[victim]->lock);
+            if (!queues[victim]->tasks.empty()) {
+                task = std::move(queues[victim]->tasks.front());
+                queues[victim]->tasks.pop_front();
+            }
+        }
+    }
+
+    if (!task) {
+        return false;
+    }
+    queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+void ThreadPool::wait(TaskGroup& group) {
+    while (group.pending.load(std::memory_order_acquire) != 0) {
+        if (!tryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ThreadPool::splitAndRun(TaskGroup& group, std::size_t lo, std::size_t hi, std::size_t grain,
+                             const std::function<void(std::size_t, std::size_t)>& fn) {
+    while (hi - lo > grain) {
+        std::size_t mid = lo + (hi - lo) / 2;
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        try {
+            push([this, &group, mid, hi, grain, &fn] {
+                try {
+                    splitAndRun(group, mid, hi, grain, fn);
+                } catch (...) {
+                    group.fail();
+                }
+                group.pending.fetch_sub(1, std::memory_order_release);
+            });
+        } catch (...) {
+            // Never queued, so nothing else will release it
+            group.pending.fetch_sub(1, std::memory_order_release);
+            throw;
+        }
+        hi = mid;
+    }
+    if (!group.failed.load(std::memory_order_acquire)) {
+        fn(lo, hi);
+    }
+}
+
+void ThreadPool::workerLoop(int index) {
+    currentWorker = index;
+    currentPool = this;
+    while (true) {
+        if (tryRunOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this] {
+            return stopping || queuedTasks.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping && queuedTasks.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+// Catalog helpers
+std::vector<Product*> ThreadPool::collectProducts(const std::vector<Vendor*>& vendors) {
+    std::vector<Product*> all;
+    std::size_t total = 0;
+    for (const Vendor* vendor : vendors) {
+        total += static_cast<std::size_t>(vendor->getProductCount());
+    }
+    all.reserve(total);
+    for (const Vendor* vendor : vendors) {
+        std::vector<Product*> products = vendor->getProducts();
+        all.insert(all.end(), products.begin(), products.end());
+    }
+    return all;
+}
@@ -0,0 +1,328 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Product.h"
+#include "Vendor.h"
+
+/**
+ * @brief Work-stealing task scheduler for catalog-wide operations
+ *
+ * Each worker owns a deque of tasks. A worker pushes and pops at the back
+ * of its own deque, so recently split work stays hot in its cache, while
+ * idle workers steal from the front of other deques, which holds the
+ * largest unsplit ranges. parallelFor() splits a range recursively until
+ * pieces reach the grain size, so the work spreads out through stealing
+ * instead of up-front partitioning. A thread that waits on a parallel
+ * call runs queued tasks itself, so parallel calls may be nested.
+ *
+ * If a callable throws, chunks not yet started are skipped, the call waits
+ * for the chunks already running and then rethrows the first exception on
+ * the calling thread.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Parameterized constructor
+     * @param threadCount Number of worker threads; 0 means one per hardware thread
+     * @pre None
+     * @post The workers are running
+     */
+    explicit ThreadPool(int threadCount = 0);
+
+    /**
+     * @brief Destructor
+     * @pre No parallel call is in progress
+     * @post All workers are joined
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Gets the number of worker threads
+     * @return The worker count
+     */
+    int getThreadCount() const;
+
+    /**
+     * @brief Runs fn(lo, hi) over disjoint chunks that cover [begin, end)
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Largest chunk handed to fn (at least 1)
+     * @param fn Callable taking (std::size_t lo, std::size_t hi)
+     * @pre fn is safe to call concurrently on disjoint chunks
+     * @post fn has run on every chunk, or the first exception fn threw is
+     *       rethrown once no chunk is still running
+     */
+    template<class ChunkFn>
+    void parallelForChunks(std::size_t begin, std::size_t end, std::size_t grain, ChunkFn fn);
+
+    /**
+     * @brief Runs fn(i) for every i in [begin, end)
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Number of indices handled per task
+     * @param fn Callable taking (std::size_t i)
+     * @pre fn is safe to call concurrently for different indices
+     * @post fn has run for every index, or the first exception fn threw is
+     *       rethrown once no chunk is still running
+     */
+    template<class IndexFn>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, IndexFn fn);
+
+    /**
+     * @brief Folds [begin, end) chunk by chunk and combines the partial results
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Largest chunk handed to map
+     * @param identity Value combined with nothing (result for an empty range)
+     * @param map Callable taking (lo, hi) and returning the chunk's T
+     * @param combine Associative callable taking (T, T) and returning T
+     * @pre map is safe to call concurrently on disjoint chunks
+     * @return The combination of every chunk's result
+     */
+    template<class T, class MapFn, class CombineFn>
+    T parallelReduce(std::size_t begin, std::size_t end, std::size_t grain,
+                     T identity, MapFn map, CombineFn combine);
+
+    /**
+     * @brief Runs fn(product) for every product in a vendor's catalog
+     * @param vendor The vendor whose catalog to visit
+     * @param grain Products per task
+     * @param fn Callable taking (Product*)
+     * @pre The catalog is not added to or removed from during the call
+     * @post fn has run on every product
+     */
+    template<class ProductFn>
+    void forEachProduct(const Vendor& vendor, std::size_t grain, ProductFn fn);
+
+    /**
+     * @brief Runs fn(product) for every product of every vendor
+     * @param vendors The vendor set
+     * @param grain Products per task
+     * @param fn Callable taking (Product*)
+     * @pre No catalog is added to or removed from during the call
+     * @post fn has run on every product
+     */
+    template<class ProductFn>
+    void forEachProduct(const std::vector<Vendor*>& vendors, std::size_t grain, ProductFn fn);
+
+    /**
+     * @brief Maps every product of a vendor to a T and combines the results
+     * @param vendor The vendor whose catalog to reduce
+     * @param grain Products per task
+     * @param identity Result for an empty catalog
+     * @param map Callable taking (const Product*) and returning T
+     * @param combine Associative callable taking (T, T) and returning T
+     * @pre The catalog is not added to or removed from during the call
+     * @return The combined result
+     */
+    template<class T, class MapFn, class CombineFn>
+    T reduceProducts(const Vendor& vendor, std::size_t grain, T identity, MapFn map, CombineFn combine);
+
+    /**
+     * @brief Maps every product of every vendor to a T and combines the results
+     * @param vendors The vendor set
+     * @param grain Products per task
+     * @param identity Result for an empty vendor set
+     * @param map Callable taking (const Product*) and returning T
+     * @param combine Associative callable taking (T, T) and returning T
+     * @pre No catalog is added to or removed from during the call
+     * @return The combined result
+     */
+    template<class T, class MapFn, class CombineFn>
+    T reduceProducts(const std::vector<Vendor*>& vendors, std::size_t grain,
+                     T identity, MapFn map, CombineFn combine);
+
+private:
+    typedef std::function<void()> Task;
+
+    /// One worker's task deque
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    /// Tracks the outstanding tasks of one parallel call
+    struct TaskGroup {
+        std::atomic<std::size_t> pending; ///< Queued or running tasks
+        std::atomic<bool> failed;         ///< Set once a chunk has thrown; later chunks are skipped
+        std::mutex errorLock;             ///< Guards error
+        std::exception_ptr error;         ///< First exception thrown by a chunk
+        TaskGroup() : pending(0), failed(false) {}
+
+        /**
+         * @brief Records the exception being handled if it is the group's first
+         * @pre Called from a catch block
+         */
+        void fail() {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error) {
+                error = std::current_exception();
+            }
+            failed.store(true, std::memory_order_release);
+        }
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue> > queues; ///< One deque per worker
+    std::vector<std::thread> workers;                  ///< Worker threads
+    std::atomic<std::size_t> queuedTasks;              ///< Tasks sitting in any deque
+    std::atomic<std::size_t> nextExternalQueue;        ///< Round-robin target for outside pushes
+    std::mutex sleepLock;                              ///< Guards stopping and idle sleeps
+    std::condition_variable wakeUp;                    ///< Signalled when work arrives or on stop
+    bool stopping;                                     ///< True once the destructor runs
+
+    /**
+     * @brief Queues a task on the calling worker's deque (or round-robin from outside)
+     * @param task The task to run
+     */
+    void push(Task task);
+
+    /**
+     * @brief Runs one queued task: own deque first, then steals
+     * @return True if a task ran, false if every deque was empty
+     */
+    bool tryRunOne();
+
+    /**
+     * @brief Runs queued tasks until the group has no pending work
+     * @param group The group to wait for
+     */
+    void wait(TaskGroup& group);
+
+    /**
+     * @brief Splits [lo, hi) in half until it fits the grain, queuing the upper halves
+     * @pre Queued halves catch their own exceptions into the group; this call may throw
+     * @param group Group that owns the range
+     * @param lo First index
+     * @param hi One past the last index
+     * @param grain Largest piece run directly
+     * @param fn Chunk function
+     */
+    void splitAndRun(TaskGroup& group, std::size_t lo, std::size_t hi, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t)>& fn);
+
+    /**
+     * @brief Worker thread body
+     * @param index The worker's own deque
+     */
+    void workerLoop(int index);
+
+    /**
+     * @brief Collects every product of a vendor set in catalog order
+     * @param vendors The vendor set
+     * @return The products, vendor by vendor
+     */
+    static std::vector<Product*> collectProducts(const std::vector<Vendor*>& vendors);
+};
+
+// Template implementations -------------------------------------------
+
+template<class ChunkFn>
+void ThreadPool::parallelForChunks(std::size_t begin, std::size_t end, std::size_t grain, ChunkFn fn) {
+    if (begin >= end) {
+        return;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+    TaskGroup group;
+    std::function<void(std::size_t, std::size_t)> chunk(fn);
+    try {
+        splitAndRun(group, begin, end, grain, chunk);
+    } catch (...) {
+        group.fail();
+    }
+    // Queued tasks still refer to group and chunk, so wait even after a throw
+    wait(group);
+    if (group.error) {
+        std::rethrow_exception(group.error);
+    }
+}
+
+template<class IndexFn>
+void ThreadPool::parallelFor(std::size_t begin, std::size_t end, std::size_t grain, IndexFn fn) {
+    parallelForChunks(begin, end, grain, [&fn](std::size_t lo, std::size_t hi) {
+        for (std::size_t i = lo; i < hi; i++) {
+            fn(i);
+        }
+    });
+}
+
+template<class T, class MapFn, class CombineFn>
+T ThreadPool::parallelReduce(std::size_t begin, std::size_t end, std::size_t grain,
+                             T identity, MapFn map, CombineFn combine) {
+    if (begin >= end) {
+        return identity;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+    // One slot per grain-aligned chunk keeps the combine order deterministic
+    std::size_t chunks = (end - begin + grain - 1) / grain;
+    std::vector<T> partials(chunks, identity);
+    parallelForChunks(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c < last; c++) {
+            std::size_t lo = begin + c * grain;
+            std::size_t hi = lo + grain < end ? lo + grain : end;
+            partials[c] = map(lo, hi);
+        }
+    });
+    T result = identity;
+    for (const T& partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+template<class ProductFn>
+void ThreadPool::forEachProduct(const Vendor& vendor, std::size_t grain, ProductFn fn) {
+    std::vector<Product*> products = vendor.getProducts();
+    parallelFor(0, products.size(), grain, [&](std::size_t i) { fn(products[i]); });
+}
+
+template<class ProductFn>
+void ThreadPool::forEachProduct(const std::vector<Vendor*>& vendors, std::size_t grain, ProductFn fn) {
+    std::vector<Product*> products = collectProducts(vendors);
+    parallelFor(0, products.size(), grain, [&](std::size_t i) { fn(products[i]); });
+}
+
+template<class T, class MapFn, class CombineFn>
+T ThreadPool::reduceProducts(const Vendor& vendor, std::size_t grain, T identity, MapFn map, CombineFn combine) {
+    std::vector<Product*> products = vendor.getProducts();
+    return parallelReduce(0, products.size(), grain, identity,
+        [&](std::size_t lo, std::size_t hi) {
+            T partial = identity;
+            for (std::size_t i = lo; i < hi; i++) {
+                partial = combine(partial, map(static_cast<const Product*>(products[i])));
+            }
+            return partial;
+        }, combine);
+}
+
+template<class T, class MapFn, class CombineFn>
+T ThreadPool::reduceProducts(const std::vector<Vendor*>& vendors, std::size_t grain,
+                             T identity, MapFn map, CombineFn combine) {
+    std::vector<Product*> products = collectProducts(vendors);
+    return parallelReduce(0, products.size(), grain, identity,
+        [&](std::size_t lo, std::size_t hi) {
+            T partial = identity;
+            for (std::size_t i = lo; i < hi; i++) {
+                partial = combine(partial, map(static_cast<const Product*>(products[i])));
+            }
+            return partial;
+        }, combine);
+}
+
+#endif // THREAD_POOL_H
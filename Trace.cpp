@@ -0,0 +1,181 @@
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+const std::uint32_t Trace::RING_CAPACITY;
+std::atomic<bool> Trace::active(false);
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    std::uint64_t ticks; // Raw timestamp from readTicks()
+    char phase;
+};
+
+// The vDSO clock costs about as much as the rest of an event on some
+// hosts, so x86 builds stamp events with the TSC and convert to
+// nanoseconds once, at export, using the steady clock as the reference.
+inline std::uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Single-writer ring; `next` is published with release so the exporter
+// sees complete slots for every index below it.
+struct TraceRing {
+    std::uint32_t threadId;
+    std::atomic<std::uint64_t> next;
+    TraceEvent events[Trace::RING_CAPACITY];
+
+    explicit TraceRing(std::uint32_t threadId) : threadId(threadId), next(0) {}
+};
+
+struct TraceRegistry {
+    std::mutex lock;
+    std::vector<TraceRing*> rings; // Never freed, so exited threads still export
+    std::string outputPath;
+    std::chrono::steady_clock::time_point origin;
+    std::uint64_t originTicks = 0;
+    bool exitHookInstalled = false;
+    std::uint32_t nextThreadId = 1;
+};
+
+TraceRegistry& registry() {
+    static TraceRegistry* instance = new TraceRegistry();
+    return *instance;
+}
+
+TraceRing& localRing() {
+    thread_local TraceRing* ring = nullptr;
+    if (ring == nullptr) {
+        TraceRegistry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        ring = new TraceRing(reg.nextThreadId++);
+        reg.rings.push_back(ring);
+    }
+    return *ring;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            out << ' ';
+        } else {
+            out << *c;
+        }
+    }
+}
+
+void stopAtExit() {
+    Trace::stop();
+}
+
+} // namespace
+
+void Trace::start(const std::string& outputPath) {
+    TraceRegistry& reg = registry();
+    {
+        std::lock_guard<std::mutex> guard(reg.lock);
+        reg.outputPath = outputPath;
+        reg.origin = std::chrono::steady_clock::now();
+        reg.originTicks = readTicks();
+        for (TraceRing* ring : reg.rings) {
+            ring->next.store(0, std::memory_order_relaxed);
+        }
+        if (!reg.exitHookInstalled) {
+            std::atexit(stopAtExit);
+            reg.exitHookInstalled = true;
+        }
+    }
+    active.store(true, std::memory_order_release);
+}
+
+void Trace::startFromEnvironment() {
+    const char* path = std::getenv("AMAZON340_TRACE");
+    if (path != nullptr && path[0] != '\0') {
+        start(path);
+    }
+}
+
+void Trace::record(const char* name, char phase) {
+    std::uint64_t ticks = readTicks();
+    TraceRing& ring = localRing();
+    std::uint64_t index = ring.next.load(std::memory_order_relaxed);
+    TraceEvent& slot = ring.events[index & (RING_CAPACITY - 1)];
+    slot.name = name;
+    slot.ticks = ticks;
+    slot.phase = phase;
+    ring.next.store(index + 1, std::memory_order_release);
+}
+
+bool Trace::stop() {
+    if (!active.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    TraceRegistry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+
+    // Nanoseconds per tick, measured over the whole traced interval
+    std::uint64_t endTicks = readTicks();
+    double elapsedNanos = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - reg.origin).count();
+    double nanosPerTick = endTicks > reg.originTicks
+        ? elapsedNanos / static_cast<double>(endTicks - reg.originTicks) : 1.0;
+
+    std::ofstream out(reg.outputPath.c_str());
+    if (!out) {
+        std::cerr << "Trace: unable to write " << reg.outputPath << std::endl;
+        return false;
+    }
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const TraceRing* ring : reg.rings) {
+        std::uint64_t end = ring->next.load(std::memory_order_acquire);
+        std::uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+        // After a wrap the oldest surviving events may be ends whose
+        // begins were overwritten; skip them so the viewer nests correctly.
+        int depth = 0;
+        for (std::uint64_t i = begin; i < end; i++) {
+            const TraceEvent& event = ring->events[i & (RING_CAPACITY - 1)];
+            if (event.phase == 'E') {
+                if (depth == 0) {
+                    continue;
+                }
+                depth--;
+            } else {
+                depth++;
+            }
+            if (!first) {
+                out << ',';
+            }
+            first = false;
+            char timestamp[32];
+            double micros = event.ticks > reg.originTicks
+                ? static_cast<double>(event.ticks - reg.originTicks) * nanosPerTick / 1000.0 : 0.0;
+            std::snprintf(timestamp, sizeof(timestamp), "%.3f", micros);
+            out << "\n{\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"ph\":\"" << event.phase << "\",\"ts\":" << timestamp
+                << ",\"pid\":1,\"tid\":" << ring->threadId << '}';
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}" << std::endl;
+    return true;
+}
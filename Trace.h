@@ -0,0 +1,113 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Opt-in session tracer that exports Chrome trace-event JSON
+ *
+ * Every thread records begin/end events into its own fixed-size ring
+ * buffer. The owning thread is the only writer, so recording is a clock
+ * read plus a slot store with no locks or read-modify-write atomics. When
+ * a ring fills up the oldest events are overwritten. The rings are
+ * written out as JSON (loadable in chrome://tracing or Perfetto) when
+ * tracing stops, which by default happens at process exit.
+ *
+ * Tracing is off unless start() is called; startFromEnvironment() turns
+ * it on when AMAZON340_TRACE names an output file. Building with
+ * AMAZON340_DISABLE_TRACE defined removes every TRACE_SCOPE site.
+ */
+class Trace {
+public:
+    /// Events kept per thread before the oldest are overwritten (power of two)
+    static const std::uint32_t RING_CAPACITY = 1u << 16;
+
+    /**
+     * @brief Starts recording and arranges for the file to be written at exit
+     * @param outputPath Path of the JSON file to write
+     * @pre None
+     * @post Trace scopes entered from now on are recorded
+     */
+    static void start(const std::string& outputPath);
+
+    /**
+     * @brief Starts tracing if the AMAZON340_TRACE environment variable is set
+     * @pre None
+     * @post Tracing is active and writes to $AMAZON340_TRACE, or nothing changes
+     */
+    static void startFromEnvironment();
+
+    /**
+     * @brief Stops recording and writes the trace file
+     * @pre None
+     * @post The trace file is written if tracing was active
+     * @return True if a file was written, false otherwise
+     */
+    static bool stop();
+
+    /**
+     * @brief Checks whether events are being recorded
+     * @return True if tracing is active, false otherwise
+     */
+    static bool enabled() {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records one event on the calling thread's ring
+     * @param name Event name; must outlive the trace (use string literals)
+     * @param phase 'B' for begin or 'E' for end
+     * @pre name points to static storage
+     * @post The event is stored in the calling thread's ring
+     */
+    static void record(const char* name, char phase);
+
+private:
+    static std::atomic<bool> active; ///< True while events are being recorded
+};
+
+/**
+ * @brief Records a begin event on construction and the matching end event on destruction
+ */
+class TraceScope {
+private:
+    const char* name; ///< Event name shown in the trace viewer
+    bool recorded;    ///< Whether the begin event was recorded
+
+public:
+    /**
+     * @brief Records the begin event if tracing is active
+     * @param name Event name; must be a string literal
+     */
+    explicit TraceScope(const char* name) : name(name), recorded(Trace::enabled()) {
+        if (recorded) {
+            Trace::record(name, 'B');
+        }
+    }
+
+    /**
+     * @brief Records the end event if the begin event was recorded
+     */
+    ~TraceScope() {
+        if (recorded) {
+            Trace::record(name, 'E');
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifndef AMAZON340_DISABLE_TRACE
+/// Traces the rest of the enclosing scope under the given literal name
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -1,14 +1,19 @@
 #include "Vendor.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "MemoryFootprint.h"
 #include <iostream>
 #include <vector>
 
 // Constructors
-Vendor::Vendor() : username(""), email(""), password(""), bio(""), profilePicture("") {}
+Vendor::Vendor() : username(""), email(""), password(""), bio(), profilePicture(),
+                   duplicateProductNames(0), uniqueProductNames(false), productRevenue(0) {}
 
 Vendor::Vendor(const std::string& username, const std::string& email, 
                const std::string& password, const std::string& bio, 
                const std::string& profilePicture)
-    : username(username), email(email), password(password), bio(bio), profilePicture(profilePicture) {}
+    : username(username), email(email), password(password), bio(bio), profilePicture(profilePicture),
+      duplicateProductNames(0), uniqueProductNames(false), productRevenue(0) {}
 
 // Destructor - Clean up products
 Vendor::~Vendor() {
@@ -20,20 +25,20 @@ Vendor::~Vendor() {
 }
 
 // Getters
-std::string Vendor::getUsername() const {
+std::string_view Vendor::getUsername() const {
     return username;
 }
 
-std::string Vendor::getEmail() const {
+std::string_view Vendor::getEmail() const {
     return email;
 }
 
-std::string Vendor::getBio() const {
-    return bio;
+ColdText::View Vendor::getBio() const {
+    return bio.load();
 }
 
-std::string Vendor::getProfilePicture() const {
-    return profilePicture;
+ColdText::View Vendor::getProfilePicture() const {
+    return profilePicture.load();
 }
 
 // Setters
@@ -50,21 +55,24 @@ void Vendor::setPassword(const std::string& password) {
 }
 
 void Vendor::setBio(const std::string& bio) {
-    this->bio = bio;
+    this->bio.assign(bio);
 }
 
 void Vendor::setProfilePicture(const std::string& profilePicture) {
-    this->profilePicture = profilePicture;
+    this->profilePicture.assign(profilePicture);
 }
 
 // Profile management
 void Vendor::displayProfile() const {
+    TRACE_SCOPE("Vendor::displayProfile");
     std::cout << "==== Vendor Profile ====" << std::endl;
     std::cout << "Username: " << username << std::endl;
     std::cout << "Email: " << email << std::endl;
-    std::cout << "Bio: " << bio << std::endl;
-    std::cout << "Profile Picture: " << profilePicture << std::endl;
+    std::cout << "Bio: " << bio.load() << std::endl;
+    std::cout << "Profile Picture: " << profilePicture.load() << std::endl;
     std::cout << "Number of Products: " << products.getCurrentSize() << std::endl;
+    std::cout << "Total Revenue: $" << Product::formatPrice(productRevenue) << std::endl;
+    ratingHistogram.display(std::cout);
 }
 
 bool Vendor::modifyPassword(const std::string& newPassword) {
@@ -75,13 +83,49 @@ bool Vendor::modifyPassword(const std::string& newPassword) {
 
 // Product management
 bool Vendor::createProduct(Product* product) {
-    if (product != nullptr) {
-        return products.add(product);
+    TRACE_SCOPE("Vendor::createProduct");
+    STATS_SCOPE(CreateProduct);
+    if (product == nullptr) {
+        return false;
     }
-    return false;
+    if (uniqueProductNames && hasProductNamed(product->getName())) {
+        std::cout << "Error: A product named \"" << product->getName() << "\" already exists." << std::endl;
+        return false;
+    }
+    if (!products.add(product)) {
+        return false;
+    }
+    
+    // add() puts the product at the head; give it a slot pointing at that node
+    std::uint32_t slot;
+    if (!freeProductSlots.empty()) {
+        slot = freeProductSlots.back();
+        freeProductSlots.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(productSlots.size());
+        productSlots.push_back(ProductSlot{nullptr, 1, 0, nullptr, 0, 0});
+    }
+    productSlots[slot].node = products.findKthItem(1);
+    productSlots[slot].stringBytes = product->getStringHeapBytes();
+    indexProductName(slot, product->getName());
+    
+    // Charge the new node and object to this vendor
+    productFootprint.nodeOverhead += sizeof(Node<Product*>);
+    productFootprint.objectHeaders += sizeof(void*);
+    productFootprint.inlineData += product->getObjectSize() - sizeof(void*);
+    productFootprint.stringHeap += productSlots[slot].stringBytes;
+    productSlots[slot].revenue = product->getRevenue();
+    productRevenue += productSlots[slot].revenue;
+    productSlots[slot].rating = product->getRating();
+    ratingHistogram.add(productSlots[slot].rating);
+    product->setId((static_cast<ProductId>(productSlots[slot].generation) << 32) | slot);
+    catalog.publish(*product);
+    invalidateSortedViews(true);
+    return true;
 }
 
 void Vendor::displayProduct(int k) const {
+    TRACE_SCOPE("Vendor::displayProduct");
     if (k <= 0 || k > products.getCurrentSize()) {
         std::cout << "Error: Invalid product index. You have " << products.getCurrentSize() << " products." << std::endl;
         return;
@@ -90,28 +134,36 @@ void Vendor::displayProduct(int k) const {
     Node<Product*>* productNode = products.findKthItem(k);
     if (productNode != nullptr) {
         Product* product = productNode->getItem();
-        std::cout << "Product #" << k << ":" << std::endl;
+        std::cout << "Product #" << k << " (ID: " << product->getId() << "):" << std::endl;
         product->display();
     }
 }
 
 void Vendor::displayAllProducts() const {
-    std::vector<Product*> productsList = products.toVector();
-    
-    if (productsList.empty()) {
+    TRACE_SCOPE("Vendor::displayAllProducts");
+    if (products.isEmpty()) {
         std::cout << "You don't have any products yet." << std::endl;
         return;
     }
     
+    // Walk the nodes directly; listing should not copy the catalog
     std::cout << "==== Your Products ====" << std::endl;
-    for (int i = 0; i < productsList.size(); i++) {
-        std::cout << "Product #" << (i + 1) << ":" << std::endl;
-        productsList[i]->display();
+    int position = 1;
+    for (Node<Product*>* curPtr = products.findKthItem(1); curPtr != nullptr; curPtr = curPtr->getNext()) {
+        Product* product = curPtr->getItem();
+        std::cout << "Product #" << position++ << " (ID: " << product->getId() << "):" << std::endl;
+        product->display();
         std::cout << "----------------------" << std::endl;
     }
 }
 
 Product* Vendor::getKthProduct(int k) const {
+    TRACE_SCOPE("Vendor::getKthProduct");
+    STATS_SCOPE(GetKthProduct);
+    return findKthProduct(k);
+}
+
+Product* Vendor::findKthProduct(int k) const {
     if (k <= 0 || k > products.getCurrentSize()) {
         std::cout << "Error: Invalid product index. You have " << products.getCurrentSize() << " products." << std::endl;
         return nullptr;
@@ -126,22 +178,43 @@ Product* Vendor::getKthProduct(int k) const {
 }
 
 bool Vendor::modifyProduct(int k) {
-    Product* product = getKthProduct(k);
+    TRACE_SCOPE("Vendor::modifyProduct");
+    Product* product = findKthProduct(k);
     if (product != nullptr) {
-        return product->modify();
+        bool modified = product->modify();
+        if (!refreshProductName(*product)) {
+            modified = false;
+        }
+        refreshProductFootprint(*product);
+        refreshProductRevenue(*product);
+        refreshProductRating(*product);
+        catalog.publish(*product);
+        invalidateSortedViews(false);
+        if (modified) {
+            std::cout << "Product modified successfully!" << std::endl;
+        }
+        return modified;
     }
     return false;
 }
 
 bool Vendor::sellProduct(int k, int quantity) {
-    Product* product = getKthProduct(k);
+    TRACE_SCOPE("Vendor::sellProduct");
+    STATS_SCOPE(SellProduct);
+    Product* product = findKthProduct(k);
     if (product != nullptr) {
-        return product->sell(quantity);
+        bool sold = product->sell(quantity);
+        refreshProductRevenue(*product);
+        catalog.publish(*product);
+        invalidateSortedViews(false);
+        return sold;
     }
     return false;
 }
 
 bool Vendor::deleteProduct(int k) {
+    TRACE_SCOPE("Vendor::deleteProduct");
+    STATS_SCOPE(DeleteProduct);
     if (k <= 0 || k > products.getCurrentSize()) {
         std::cout << "Error: Invalid product index. You have " << products.getCurrentSize() << " products." << std::endl;
         return false;
@@ -151,15 +224,16 @@ bool Vendor::deleteProduct(int k) {
     Node<Product*>* productNode = products.findKthItem(k);
     if (productNode != nullptr) {
         Product* product = productNode->getItem();
-        // Store a temporary copy of the product for comparison
-        Product* productCopy = product;
         
-        // Remove from bag
-        bool removed = products.remove(product);
+        // Unlink the node we already found; the other products keep their positions
+        bool removed = products.removeNode(productNode);
         
-        // If successfully removed, delete the product
+        // If successfully removed, retire its ID and delete the product
         if (removed) {
-            delete productCopy;
+            catalog.retire(product->getId());
+            invalidateSortedViews(true);
+            releaseProductSlot(*product);
+            delete product;
             std::cout << "Product deleted successfully!" << std::endl;
             return true;
         }
@@ -169,10 +243,381 @@ bool Vendor::deleteProduct(int k) {
     return false;
 }
 
+// Stable ID access
+Product* Vendor::getProductById(ProductId id) const {
+    Node<Product*>* productNode = findProductNode(id);
+    if (productNode == nullptr) {
+        std::cout << "Error: Unknown or stale product ID " << id << "." << std::endl;
+        return nullptr;
+    }
+    return productNode->getItem();
+}
+
+void Vendor::displayProductById(ProductId id) const {
+    TRACE_SCOPE("Vendor::displayProductById");
+    Product* product = getProductById(id);
+    if (product != nullptr) {
+        std::cout << "Product ID " << id << ":" << std::endl;
+        product->display();
+    }
+}
+
+bool Vendor::modifyProductById(ProductId id) {
+    TRACE_SCOPE("Vendor::modifyProductById");
+    Product* product = getProductById(id);
+    if (product != nullptr) {
+        bool modified = product->modify();
+        if (!refreshProductName(*product)) {
+            modified = false;
+        }
+        refreshProductFootprint(*product);
+        refreshProductRevenue(*product);
+        refreshProductRating(*product);
+        catalog.publish(*product);
+        invalidateSortedViews(false);
+        if (modified) {
+            std::cout << "Product modified successfully!" << std::endl;
+        }
+        return modified;
+    }
+    return false;
+}
+
+bool Vendor::sellProductById(ProductId id, int quantity) {
+    TRACE_SCOPE("Vendor::sellProductById");
+    STATS_SCOPE(SellProduct);
+    Product* product = getProductById(id);
+    if (product != nullptr) {
+        bool sold = product->sell(quantity);
+        refreshProductRevenue(*product);
+        catalog.publish(*product);
+        invalidateSortedViews(false);
+        return sold;
+    }
+    return false;
+}
+
+bool Vendor::deleteProductById(ProductId id) {
+    TRACE_SCOPE("Vendor::deleteProductById");
+    STATS_SCOPE(DeleteProduct);
+    Node<Product*>* productNode = findProductNode(id);
+    if (productNode == nullptr) {
+        std::cout << "Error: Unknown or stale product ID " << id << "." << std::endl;
+        return false;
+    }
+    
+    Product* product = productNode->getItem();
+    if (products.removeNode(productNode)) {
+        catalog.retire(id);
+        invalidateSortedViews(true);
+        releaseProductSlot(*product);
+        delete product;
+        std::cout << "Product deleted successfully!" << std::endl;
+        return true;
+    }
+    
+    std::cout << "Failed to delete the product." << std::endl;
+    return false;
+}
+
+// Revenue
+Cents Vendor::getRevenue() const {
+    return productRevenue;
+}
+
+// Ratings
+const RatingHistogram& Vendor::getRatingHistogram() const {
+    return ratingHistogram;
+}
+
+// Name uniqueness
+bool Vendor::setUniqueProductNames(bool unique) {
+    if (unique && duplicateProductNames > 0) {
+        std::cout << "Error: " << duplicateProductNames
+                  << " product(s) share a name with another product. Rename or delete them first." << std::endl;
+        return false;
+    }
+    uniqueProductNames = unique;
+    return true;
+}
+
+bool Vendor::hasUniqueProductNames() const {
+    return uniqueProductNames;
+}
+
+bool Vendor::hasProductNamed(std::string_view name) const {
+    return findProductName(name) != productNameCounts.end();
+}
+
+std::size_t Vendor::searchProducts(std::string_view text, std::vector<Product*>& matches) const {
+    TRACE_SCOPE("Vendor::searchProducts");
+    matches.clear();
+    for (Node<Product*>* curPtr = products.findKthItem(1); curPtr != nullptr; curPtr = curPtr->getNext()) {
+        Product* product = curPtr->getItem();
+        if (product->getName().find(text) != std::string_view::npos
+            || product->getDescription().text().find(text) != std::string_view::npos) {
+            matches.push_back(product);
+        }
+    }
+    return matches.size();
+}
+
+// Versioned catalog access
+std::shared_ptr<const CatalogSnapshot> Vendor::getCatalogSnapshot() const {
+    return catalog.snapshot();
+}
+
+bool Vendor::publishProduct(ProductId id) {
+    Product* product = getProductById(id);
+    if (product != nullptr) {
+        bool renamed = refreshProductName(*product);
+        refreshProductFootprint(*product);
+        refreshProductRevenue(*product);
+        refreshProductRating(*product);
+        catalog.publish(*product);
+        invalidateSortedViews(false);
+        return renamed;
+    }
+    return false;
+}
+
+// Sorted views
+void Vendor::invalidateSortedViews(bool membershipChanged) {
+    for (int key = 0; key < SORT_KEY_COUNT; key++) {
+        viewOrderStale[key] = true;
+        if (membershipChanged) {
+            viewMembershipStale[key] = true;
+        }
+    }
+}
+
+const LinkedBag<Product*>& Vendor::getSortedView(ProductSortKey key) const {
+    int index = static_cast<int>(key);
+    LinkedBag<Product*>& view = sortedViews[index];
+    
+    // Products were added or removed: start over from the catalog
+    if (viewMembershipStale[index]) {
+        view = products;
+        viewMembershipStale[index] = false;
+        viewOrderStale[index] = true;
+    }
+    
+    // Only field values changed: re-sort the existing nodes in place
+    if (viewOrderStale[index]) {
+        switch (key) {
+            case ProductSortKey::Rating:
+                view.sort([](Product* a, Product* b) { return a->getRating() > b->getRating(); });
+                break;
+            case ProductSortKey::SoldCount:
+                view.sort([](Product* a, Product* b) { return a->getSoldCount() > b->getSoldCount(); });
+                break;
+            case ProductSortKey::Name:
+                view.sort([](Product* a, Product* b) { return a->getName() < b->getName(); });
+                break;
+        }
+        viewOrderStale[index] = false;
+    }
+    return view;
+}
+
+std::vector<Product*> Vendor::getProductsSortedBy(ProductSortKey key) const {
+    return getSortedView(key).toVector();
+}
+
+void Vendor::displayProductsSortedBy(ProductSortKey key) const {
+    TRACE_SCOPE("Vendor::displayProductsSortedBy");
+    const LinkedBag<Product*>& view = getSortedView(key);
+    if (view.isEmpty()) {
+        std::cout << "You don't have any products yet." << std::endl;
+        return;
+    }
+    
+    static const char* const keyNames[SORT_KEY_COUNT] = {"Rating", "Sold Count", "Name"};
+    std::cout << "==== Your Products by " << keyNames[static_cast<int>(key)] << " ====" << std::endl;
+    int position = 1;
+    for (Node<Product*>* curPtr = view.findKthItem(1); curPtr != nullptr; curPtr = curPtr->getNext()) {
+        Product* product = curPtr->getItem();
+        std::cout << position++ << ". (ID: " << product->getId() << ")" << std::endl;
+        product->display();
+        std::cout << "----------------------" << std::endl;
+    }
+}
+
+// Memory accounting
+MemoryFootprint Vendor::getMemoryFootprint() const {
+    // Product costs are kept current on every mutation; only the
+    // vendor's own fields and container capacities are read here.
+    MemoryFootprint footprint = productFootprint;
+    footprint.nodeOverhead += productSlots.capacity() * sizeof(ProductSlot)
+                            + freeProductSlots.capacity() * sizeof(std::uint32_t);
+    // Name index: bucket array plus one node (next pointer, key, count) per name
+    footprint.nodeOverhead += productNameCounts.bucket_count() * sizeof(void*)
+                            + productNameCounts.size() * (sizeof(void*) + sizeof(std::pair<const std::string, int>));
+    for (int key = 0; key < SORT_KEY_COUNT; key++) {
+        footprint.nodeOverhead += sortedViews[key].getCurrentSize() * sizeof(Node<Product*>);
+    }
+    footprint.inlineData += sizeof(Vendor);
+    // The bio and profile picture are counted by ColdTextStore
+    footprint.stringHeap += stringHeapBytes(username) + stringHeapBytes(email) + stringHeapBytes(password);
+    return footprint;
+}
+
+void Vendor::displayMemoryUsage() const {
+    MemoryFootprint footprint = getMemoryFootprint();
+    std::cout << "==== Memory Usage ====" << std::endl;
+    std::cout << "Products: " << products.getCurrentSize() << std::endl;
+    footprint.display(std::cout);
+    if (products.getCurrentSize() > 0) {
+        std::cout << "Bytes per product: " << footprint.total() / products.getCurrentSize() << std::endl;
+    }
+    ColdTextStore::display(std::cout);
+}
+
+// Slot map helpers
+Node<Product*>* Vendor::findProductNode(ProductId id) const {
+    std::uint32_t slot = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+    std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+    if (id == 0 || slot >= productSlots.size()) {
+        return nullptr;
+    }
+    const ProductSlot& entry = productSlots[slot];
+    if (entry.node == nullptr || entry.generation != generation) {
+        return nullptr;
+    }
+    return entry.node;
+}
+
+void Vendor::releaseProductSlot(const Product& product) {
+    ProductId id = product.getId();
+    std::uint32_t slot = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+    if (findProductNode(id) == nullptr) {
+        return;
+    }
+    
+    // Give back what createProduct() charged, with the latest string size
+    productFootprint.nodeOverhead -= sizeof(Node<Product*>);
+    productFootprint.objectHeaders -= sizeof(void*);
+    productFootprint.inlineData -= product.getObjectSize() - sizeof(void*);
+    productFootprint.stringHeap -= productSlots[slot].stringBytes;
+    productRevenue -= productSlots[slot].revenue;
+    productSlots[slot].revenue = 0;
+    ratingHistogram.remove(productSlots[slot].rating);
+    
+    unindexProductName(slot);
+    productSlots[slot].node = nullptr;
+    productSlots[slot].stringBytes = 0;
+    // Generation 0 is never handed out, so ID 0 always means "unassigned"
+    if (++productSlots[slot].generation == 0) {
+        productSlots[slot].generation = 1;
+    }
+    freeProductSlots.push_back(slot);
+}
+
+void Vendor::indexProductName(std::uint32_t slot, std::string_view name) {
+    std::pair<ProductNameCounts::iterator, bool> entry = productNameCounts.emplace(name, 0);
+    if (entry.second) {
+        productFootprint.stringHeap += stringHeapBytes(entry.first->first);
+    } else {
+        duplicateProductNames++;
+    }
+    entry.first->second++;
+    // Keys never move while in the map, so the slot can point at this one
+    productSlots[slot].indexedName = &entry.first->first;
+}
+
+void Vendor::unindexProductName(std::uint32_t slot) {
+    const std::string* name = productSlots[slot].indexedName;
+    if (name == nullptr) {
+        return;
+    }
+    productSlots[slot].indexedName = nullptr;
+    ProductNameCounts::iterator entry = productNameCounts.find(*name);
+    if (entry == productNameCounts.end()) {
+        return;
+    }
+    if (--entry->second > 0) {
+        duplicateProductNames--;
+    } else {
+        productFootprint.stringHeap -= stringHeapBytes(entry->first);
+        productNameCounts.erase(entry);
+    }
+}
+
+Vendor::ProductNameCounts::const_iterator Vendor::findProductName(std::string_view name) const {
+#if defined(__cpp_lib_generic_unordered_lookup)
+    return productNameCounts.find(name);
+#else
+    // Before C++20 unordered_map::find() only takes the key type
+    return productNameCounts.find(std::string(name));
+#endif
+}
+
+bool Vendor::refreshProductName(Product& product) {
+    ProductId id = product.getId();
+    if (findProductNode(id) == nullptr) {
+        return true;
+    }
+    std::uint32_t slot = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+    const std::string* indexedName = productSlots[slot].indexedName;
+    std::string_view currentName = product.getName();
+    if (indexedName != nullptr && *indexedName == currentName) {
+        return true;
+    }
+    
+    if (uniqueProductNames && indexedName != nullptr && hasProductNamed(currentName)) {
+        std::cout << "Error: A product named \"" << currentName << "\" already exists. "
+                  << "Keeping the name \"" << *indexedName << "\"." << std::endl;
+        product.setName(*indexedName);
+        return false;
+    }
+    unindexProductName(slot);
+    indexProductName(slot, currentName);
+    return true;
+}
+
+void Vendor::refreshProductRevenue(const Product& product) {
+    ProductId id = product.getId();
+    if (findProductNode(id) == nullptr) {
+        return;
+    }
+    ProductSlot& entry = productSlots[static_cast<std::uint32_t>(id & 0xFFFFFFFFu)];
+    Cents current = product.getRevenue();
+    productRevenue += current - entry.revenue;
+    entry.revenue = current;
+}
+
+void Vendor::refreshProductRating(const Product& product) {
+    ProductId id = product.getId();
+    if (findProductNode(id) == nullptr) {
+        return;
+    }
+    ProductSlot& entry = productSlots[static_cast<std::uint32_t>(id & 0xFFFFFFFFu)];
+    if (entry.rating != product.getRating()) {
+        ratingHistogram.remove(entry.rating);
+        entry.rating = product.getRating();
+        ratingHistogram.add(entry.rating);
+    }
+}
+
+void Vendor::refreshProductFootprint(const Product& product) {
+    ProductId id = product.getId();
+    if (findProductNode(id) == nullptr) {
+        return;
+    }
+    ProductSlot& entry = productSlots[static_cast<std::uint32_t>(id & 0xFFFFFFFFu)];
+    std::size_t current = product.getStringHeapBytes();
+    productFootprint.stringHeap = productFootprint.stringHeap - entry.stringBytes + current;
+    entry.stringBytes = current;
+}
+
 int Vendor::getProductCount() const {
     return products.getCurrentSize();
 }
 
+std::vector<Product*> Vendor::getProducts() const {
+    return products.toVector();
+}
+
 // Operator overloading implementation
 bool Vendor::operator==(const Vendor& otherVendor) const {
     return (username == otherVendor.username) && (email == otherVendor.email);
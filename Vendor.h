@@ -1,11 +1,29 @@
 #ifndef VENDOR_H
 #define VENDOR_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <vector>
+#include <memory>
+#include <unordered_map>
 #include "Product.h"
+#include "CatalogSnapshot.h"
+#include "ColdText.h"
+#include "MemoryFootprint.h"
+#include "RatingHistogram.h"
 #include "LinkedBagDS/LinkedBag.h"
 
+/**
+ * @brief Orderings offered by Vendor's sorted product views
+ */
+enum class ProductSortKey {
+    Rating,     ///< Highest rating first
+    SoldCount,  ///< Most units sold first
+    Name        ///< Alphabetical by name
+};
+
 /**
  * @brief Class representing a vendor selling products
  *
@@ -17,10 +35,128 @@ private:
     std::string username;        ///< Vendor's username
     std::string email;           ///< Vendor's email address
     std::string password;        ///< Vendor's password
-    std::string bio;             ///< Vendor's biographical information
-    std::string profilePicture;  ///< Path/URL to vendor's profile picture
+    ColdText bio;                ///< Vendor's biographical information, loaded on access
+    ColdText profilePicture;     ///< Path/URL to vendor's profile picture, loaded on access
     LinkedBag<Product*> products; ///< Collection of products the vendor sells
+    
+    /// Slot map entry: the node holding a product and the slot's current generation
+    struct ProductSlot {
+        Node<Product*>* node;       ///< Node in products, or nullptr if the slot is free
+        std::uint32_t generation;   ///< Bumped each time the slot is released
+        std::size_t stringBytes;    ///< String heap bytes last charged for the product
+        const std::string* indexedName; ///< Key in productNameCounts the product is counted under
+        Cents revenue;              ///< Product revenue last added to productRevenue
+        int rating;                 ///< Rating the product is counted under in ratingHistogram
+    };
+    /// Hashes names through std::string_view so lookups by view need no std::string
+    struct ProductNameHash {
+        typedef void is_transparent;
+        std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+    };
+    typedef std::unordered_map<std::string, int, ProductNameHash, std::equal_to<> > ProductNameCounts;
 
+    std::vector<ProductSlot> productSlots;      ///< Slot map backing ProductId lookups
+    std::vector<std::uint32_t> freeProductSlots; ///< Indices of released slots
+    ProductNameCounts productNameCounts; ///< Live products per name
+    int duplicateProductNames;   ///< Products sharing a name with an earlier one
+    bool uniqueProductNames;     ///< Reject products whose name is already taken
+    Cents productRevenue;        ///< Sum of price * soldCount over the products, updated on mutation
+    RatingHistogram ratingHistogram; ///< Products per rating, updated on mutation
+    VersionedCatalog catalog;    ///< Published read-only versions of the products
+    MemoryFootprint productFootprint; ///< Running byte counts for the products, updated on mutation
+    
+    static const int SORT_KEY_COUNT = 3; ///< Number of ProductSortKey values
+    mutable LinkedBag<Product*> sortedViews[SORT_KEY_COUNT]; ///< Products ordered by each key, sorted on demand
+    mutable bool viewMembershipStale[SORT_KEY_COUNT] = {true, true, true}; ///< View must be re-copied from products
+    mutable bool viewOrderStale[SORT_KEY_COUNT] = {true, true, true};      ///< View must be re-sorted
+    
+    /**
+     * @brief Marks every sorted view out of date
+     * @param membershipChanged True if products were added or removed, false if only fields changed
+     * @post The next access to a view re-copies and/or re-sorts it
+     */
+    void invalidateSortedViews(bool membershipChanged);
+    
+    /**
+     * @brief Gets a sorted view, bringing it up to date first if needed
+     * @param key The ordering
+     * @return The view; valid until the next mutation of this vendor
+     */
+    const LinkedBag<Product*>& getSortedView(ProductSortKey key) const;
+    
+    /**
+     * @brief Resolves an ID to its node
+     * @param id The product ID
+     * @return The node holding the product, or nullptr if the ID is unknown or stale
+     */
+    Node<Product*>* findProductNode(ProductId id) const;
+    
+    /**
+     * @brief Finds the kth product without counting a getKthProduct call
+     * @param k The index of the product (1-based)
+     * @return Pointer to the product, or nullptr (an error is printed) if k is out of range
+     */
+    Product* findKthProduct(int k) const;
+    
+    /**
+     * @brief Frees the slot of a product that is leaving the catalog
+     * @param product The product being removed (still alive)
+     * @post The ID no longer resolves, the slot can be reused and the
+     *       product's bytes are no longer counted
+     */
+    void releaseProductSlot(const Product& product);
+    
+    /**
+     * @brief Counts a product under a name
+     * @param slot The product's slot
+     * @param name The product's name
+     * @post The slot refers to the name's key in productNameCounts
+     */
+    void indexProductName(std::uint32_t slot, std::string_view name);
+    
+    /**
+     * @brief Looks a name up in productNameCounts
+     * @param name The name
+     * @return The name's entry, or end() if no product has it
+     */
+    ProductNameCounts::const_iterator findProductName(std::string_view name) const;
+    
+    /**
+     * @brief Stops counting a product under its indexed name
+     * @param slot The product's slot
+     * @post The name's key is erased once no product uses it
+     */
+    void unindexProductName(std::uint32_t slot);
+    
+    /**
+     * @brief Moves a product to its current name in the name index after it may have been renamed
+     * @param product The product
+     * @post In unique-name mode, a rename onto a taken name is undone
+     * @return False if the rename was undone, true otherwise
+     */
+    bool refreshProductName(Product& product);
+    
+    /**
+     * @brief Re-reads a product's revenue after its price or sold count may have changed
+     * @param product The product
+     * @post productRevenue reflects the product's current price and sold count
+     */
+    void refreshProductRevenue(const Product& product);
+    
+    /**
+     * @brief Re-counts a product in the rating histogram after its rating may have changed
+     * @param product The product
+     * @post ratingHistogram counts the product under its current rating
+     */
+    void refreshProductRating(const Product& product);
+    
+    /**
+     * @brief Re-measures a product's string heap after it may have changed
+     * @param product The product
+     * @post productFootprint reflects the product's current strings
+     */
+    void refreshProductFootprint(const Product& product);
+    
 public:
     /**
      * @brief Default constructor
@@ -43,6 +179,16 @@ public:
            const std::string& password, const std::string& bio, 
            const std::string& profilePicture);
     
+    /**
+     * @brief Vendors are not copyable
+     *
+     * A vendor owns its products and deletes them, and its slot map, name
+     * index and running totals all refer to those objects; share a vendor
+     * by reference instead.
+     */
+    Vendor(const Vendor& otherVendor) = delete;
+    Vendor& operator=(const Vendor& otherVendor) = delete;
+    
     /**
      * @brief Destructor
      * @pre None
@@ -52,27 +198,27 @@ public:
     
     /**
      * @brief Gets the vendor's username
-     * @return The username as a string
+     * @return A view of the username, valid until it is next changed
      */
-    std::string getUsername() const;
+    std::string_view getUsername() const;
     
     /**
      * @brief Gets the vendor's email address
-     * @return The email address as a string
+     * @return A view of the email address, valid until it is next changed
      */
-    std::string getEmail() const;
+    std::string_view getEmail() const;
     
     /**
-     * @brief Gets the vendor's biographical information
-     * @return The bio as a string
+     * @brief Gets the vendor's biographical information, reading it back from disk if it was paged out
+     * @return The loaded bio, valid while the returned view exists
      */
-    std::string getBio() const;
+    ColdText::View getBio() const;
     
     /**
-     * @brief Gets the vendor's profile picture path/URL
-     * @return The profile picture path/URL as a string
+     * @brief Gets the vendor's profile picture path/URL, reading it back from disk if it was paged out
+     * @return The loaded profile picture path/URL, valid while the returned view exists
      */
-    std::string getProfilePicture() const;
+    ColdText::View getProfilePicture() const;
     
     /**
      * @brief Sets the vendor's username
@@ -117,7 +263,7 @@ public:
     /**
      * @brief Displays the vendor's profile information
      * @pre None
-     * @post The vendor's profile information is displayed
+     * @post The vendor's profile information, revenue and rating summary are displayed
      */
     void displayProfile() const;
     
@@ -134,11 +280,59 @@ public:
      * @brief Adds a new product to the vendor's catalog
      * @param product Pointer to the product to add
      * @pre product is a valid pointer to a Product object
-     * @post The product is added to the vendor's catalog if creation is successful
+     * @post The product is added to the vendor's catalog and given a stable ID
+     *       (see Product::getId) if creation is successful. In unique-name mode
+     *       a product whose name is already taken is rejected in expected O(1)
      * @return True if the product was successfully added, false otherwise
+     *         (the caller still owns the product)
      */
     bool createProduct(Product* product);
     
+    /**
+     * @brief Gets the vendor's revenue in O(1)
+     * @pre Products changed outside this class's methods count once passed to publishProduct()
+     * @return The sum of price * soldCount over all products, in cents
+     */
+    Cents getRevenue() const;
+    
+    /**
+     * @brief Gets the vendor's rating histogram
+     * @pre Products changed outside this class's methods count once passed to publishProduct()
+     * @return Products per rating; average, median and distribution queries on it are O(1)
+     */
+    const RatingHistogram& getRatingHistogram() const;
+    
+    /**
+     * @brief Turns unique-name mode on or off
+     * @param unique True to reject products (new or renamed) whose name is already taken
+     * @pre None
+     * @post The mode is changed unless the catalog already holds duplicate names
+     * @return True if the mode was changed, false if duplicates prevent turning it on
+     */
+    bool setUniqueProductNames(bool unique);
+    
+    /**
+     * @brief Checks whether unique-name mode is on
+     * @return True if product names must be unique, false otherwise
+     */
+    bool hasUniqueProductNames() const;
+    
+    /**
+     * @brief Checks whether a product with the given name exists, in expected O(1)
+     * @param name The product name
+     * @return True if at least one product has this name, false otherwise
+     */
+    bool hasProductNamed(std::string_view name) const;
+    
+    /**
+     * @brief Finds the products whose name or description contains some text
+     * @param text The text to look for (case-sensitive); empty text matches every product
+     * @param matches Cleared, then filled with the matching products in catalog order
+     * @post Nothing is allocated once matches has room for the results
+     * @return The number of matches
+     */
+    std::size_t searchProducts(std::string_view text, std::vector<Product*>& matches) const;
+    
     /**
      * @brief Displays information for a specific product
      * @param k The index of the product to display (1-based)
@@ -158,7 +352,8 @@ public:
      * @brief Modifies details of a specific product
      * @param k The index of the product to modify (1-based)
      * @pre None
-     * @post The product is modified if the index is valid and modification is successful
+     * @post The product is modified if the index is valid and modification is successful;
+     *       success is printed only after a rename is accepted (see setUniqueProductNames)
      * @return True if the product was successfully modified, false otherwise
      */
     bool modifyProduct(int k);
@@ -190,6 +385,100 @@ public:
      */
     Product* getKthProduct(int k) const;
     
+    /**
+     * @brief Gets a product by its stable ID
+     * @param id The product ID
+     * @pre None
+     * @return Pointer to the product in O(1), or nullptr if the ID is unknown or stale
+     */
+    Product* getProductById(ProductId id) const;
+    
+    /**
+     * @brief Displays a product identified by its stable ID
+     * @param id The product ID
+     * @pre None
+     * @post The product information is displayed if the ID is valid
+     */
+    void displayProductById(ProductId id) const;
+    
+    /**
+     * @brief Modifies a product identified by its stable ID
+     * @param id The product ID
+     * @pre None
+     * @post The product is modified if the ID is valid and modification is successful;
+     *       success is printed only after a rename is accepted (see setUniqueProductNames)
+     * @return True if the product was successfully modified, false otherwise
+     */
+    bool modifyProductById(ProductId id);
+    
+    /**
+     * @brief Sells a quantity of a product identified by its stable ID
+     * @param id The product ID
+     * @param quantity The quantity to sell
+     * @pre None
+     * @post The product's sell method is called if the ID is valid
+     * @return True if the sale was successful, false otherwise
+     */
+    bool sellProductById(ProductId id, int quantity);
+    
+    /**
+     * @brief Removes a product identified by its stable ID in O(1)
+     * @param id The product ID
+     * @pre None
+     * @post The product is removed and deleted and its ID becomes stale
+     * @return True if the product was successfully deleted, false otherwise
+     */
+    bool deleteProductById(ProductId id);
+    
+    /**
+     * @brief Gets the current read-only version of the catalog
+     * @pre None
+     * @return An immutable snapshot that can be iterated without locks from any thread
+     */
+    std::shared_ptr<const CatalogSnapshot> getCatalogSnapshot() const;
+    
+    /**
+     * @brief Publishes a product's current fields to the catalog snapshots
+     * @param id The product ID
+     * @pre Needed only after changing a product outside this class's methods
+     *      (e.g. through getKthProduct or an OrderPipeline)
+     * @post New snapshots reflect the product's current fields. In unique-name
+     *      mode a rename onto a taken name is undone (an error is printed)
+     * @return False if no product has this ID or a rename was undone, true otherwise
+     */
+    bool publishProduct(ProductId id);
+    
+    /**
+     * @brief Gets the products in the given order
+     * @param key The ordering
+     * @pre None
+     * @return The products, sorted by key; ties keep their previous relative order
+     */
+    std::vector<Product*> getProductsSortedBy(ProductSortKey key) const;
+    
+    /**
+     * @brief Displays all products in the given order
+     * @param key The ordering
+     * @pre None
+     * @post The products are displayed in sorted order. The view is re-sorted
+     *       only if a mutation invalidated it since the last listing
+     */
+    void displayProductsSortedBy(ProductSortKey key) const;
+    
+    /**
+     * @brief Gets the memory attributed to this vendor
+     * @pre None
+     * @return Bytes split into node overhead, object headers, inline data and string heap
+     */
+    MemoryFootprint getMemoryFootprint() const;
+    
+    /**
+     * @brief Displays the vendor's memory footprint
+     * @pre None
+     * @post The footprint breakdown and the cold text store's totals are displayed
+     */
+    void displayMemoryUsage() const;
+    
     /**
      * @brief Gets the total number of products in the vendor's catalog
      * @pre None
@@ -197,6 +486,13 @@ public:
      */
     int getProductCount() const;
     
+    /**
+     * @brief Gets the vendor's products in catalog order
+     * @pre None
+     * @return A vector of pointers to the products (owned by the vendor)
+     */
+    std::vector<Product*> getProducts() const;
+    
     /**
      * @brief Equality comparison operator
      * @param otherVendor The vendor to compare with
@@ -0,0 +1,629 @@
+#include "VendorServer.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+const std::size_t VendorServer::MAX_LINE;
+const std::size_t VendorServer::MAX_PENDING_OUTPUT;
+const std::size_t VendorServer::MAX_PENDING_INPUT;
+const int VendorServer::MAX_EVENTS;
+
+namespace {
+
+// Vendor and Product methods print for the interactive menu; the server
+// replies over the socket instead, so their output is discarded
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+class QuietCout {
+public:
+    QuietCout() : saved(std::cout.rdbuf(&discard)) {}
+    ~QuietCout() { std::cout.rdbuf(saved); }
+private:
+    NullBuffer discard;
+    std::streambuf* saved;
+};
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Tab-separated if the line has a tab, otherwise split on runs of spaces
+std::vector<std::string> splitRequest(const std::string& line) {
+    std::vector<std::string> fields;
+    if (line.find('\t') != std::string::npos) {
+        std::size_t start = 0;
+        while (true) {
+            std::size_t tab = line.find('\t', start);
+            fields.push_back(line.substr(start, tab - start));
+            if (tab == std::string::npos) {
+                break;
+            }
+            start = tab + 1;
+        }
+        return fields;
+    }
+    std::size_t pos = 0;
+    while (pos < line.size()) {
+        while (pos < line.size() && line[pos] == ' ') {
+            pos++;
+        }
+        std::size_t end = line.find(' ', pos);
+        if (end == std::string::npos) {
+            end = line.size();
+        }
+        if (end > pos) {
+            fields.push_back(line.substr(pos, end - pos));
+        }
+        pos = end;
+    }
+    return fields;
+}
+
+bool parseInt(const std::string& text, int& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || errno != 0 || parsed < -2147483647L || parsed > 2147483647L) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// Keeps a field from breaking the line framing
+std::string clean(std::string_view text) {
+    std::string result(text);
+    std::replace(result.begin(), result.end(), '\t', ' ');
+    std::replace(result.begin(), result.end(), '\n', ' ');
+    std::replace(result.begin(), result.end(), '\r', ' ');
+    return result;
+}
+
+std::string productLine(const Product& product) {
+    std::string line = std::to_string(product.getId());
+    const Good* good = dynamic_cast<const Good*>(&product);
+    line += good != nullptr ? "\tgood\t" : "\tmedia\t";
+    line += clean(product.getName()) + "\t" + clean(product.getDescription()) + "\t"
+          + std::to_string(product.getRating()) + "\t" + Product::formatPrice(product.getPrice()) + "\t"
+          + std::to_string(product.getSoldCount()) + "\t";
+    if (good != nullptr) {
+        line += clean(good->getExpirationDate()) + "\t" + std::to_string(good->getQuantity());
+    } else {
+        const Media& media = static_cast<const Media&>(product);
+        line += clean(media.getType()) + "\t" + clean(media.getTargetAudience());
+    }
+    return line;
+}
+
+std::string error(const std::string& message) {
+    return "ERR " + message + "\n";
+}
+
+} // namespace
+
+// Constructor
+VendorServer::VendorServer(Vendor& vendor)
+    : vendor(vendor), listenFd(-1), epollFd(-1), wakeFd(-1), spareFd(-1), listenPaused(false), port(0),
+      stopping(false), requestsServed(0) {}
+
+// Destructor - close everything we opened
+VendorServer::~VendorServer() {
+    for (std::unordered_map<int, Connection>::iterator it = connections.begin(); it != connections.end(); ++it) {
+        close(it->first);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+    }
+    if (spareFd >= 0) {
+        close(spareFd);
+    }
+    if (!unixPath.empty()) {
+        unlink(unixPath.c_str());
+    }
+}
+
+// Listening
+bool VendorServer::listenTcp(int port) {
+    if (listenFd >= 0) {
+        std::cout << "Error: The server is already listening." << std::endl;
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cout << "Error: Could not create a socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fd, SOMAXCONN) != 0 || !setNonBlocking(fd)) {
+        std::cout << "Error: Could not listen on port " << port << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+    this->port = ntohs(address.sin_port);
+    listenFd = fd;
+    return true;
+}
+
+bool VendorServer::listenUnix(const std::string& path) {
+    if (listenFd >= 0) {
+        std::cout << "Error: The server is already listening." << std::endl;
+        return false;
+    }
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cout << "Error: Invalid Unix socket path." << std::endl;
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cout << "Error: Could not create a socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fd, SOMAXCONN) != 0 || !setNonBlocking(fd)) {
+        std::cout << "Error: Could not listen on " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    unixPath = path;
+    listenFd = fd;
+    return true;
+}
+
+// Event loop
+bool VendorServer::run() {
+    if (listenFd < 0) {
+        std::cout << "Error: The server is not listening." << std::endl;
+        return false;
+    }
+    if (epollFd < 0 && !prepareLoop()) {
+        return false;
+    }
+
+    epoll_event events[MAX_EVENTS];
+    while (!stopping.load()) {
+        int ready = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cout << "Error: epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        TRACE_SCOPE("VendorServer::events");
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+            if (fd == wakeFd) {
+                std::uint64_t count;
+                ssize_t ignored = read(wakeFd, &count, sizeof(count));
+                (void)ignored;
+                continue;
+            }
+
+            std::unordered_map<int, Connection>::iterator found = connections.find(fd);
+            if (found == connections.end()) {
+                continue;
+            }
+            Connection& connection = found->second;
+            bool keep = true;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                keep = false;
+            }
+            if (keep && (events[i].events & EPOLLIN)) {
+                keep = readFrom(fd, connection);
+            }
+            if (keep && (events[i].events & EPOLLOUT)) {
+                // Room to send again: answer requests held back by backpressure
+                keep = flush(fd, connection) && answerInput(fd, connection);
+            }
+            if (!keep) {
+                closeConnection(fd);
+            }
+        }
+    }
+
+    std::vector<int> open;
+    for (std::unordered_map<int, Connection>::iterator it = connections.begin(); it != connections.end(); ++it) {
+        open.push_back(it->first);
+    }
+    for (int fd : open) {
+        closeConnection(fd);
+    }
+    stopping.store(false);
+    return true;
+}
+
+void VendorServer::stop() {
+    stopping.store(true);
+    if (wakeFd >= 0) {
+        std::uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+// Requests
+std::string VendorServer::handleRequest(const std::string& line) {
+    TRACE_SCOPE("VendorServer::handleRequest");
+    requestsServed.fetch_add(1, std::memory_order_relaxed);
+    std::vector<std::string> fields = splitRequest(line);
+    if (fields.empty()) {
+        return error("empty request");
+    }
+    std::string command = fields[0];
+    std::transform(command.begin(), command.end(), command.begin(), ::toupper);
+    QuietCout quiet;
+
+    if (command == "PING") {
+        return "OK PONG\n";
+    }
+    if (command == "COUNT") {
+        return "OK " + std::to_string(vendor.getProductCount()) + "\n";
+    }
+    if (command == "LIST") {
+        std::vector<Product*> products = vendor.getProducts();
+        std::string reply = "OK " + std::to_string(products.size()) + "\n";
+        for (const Product* product : products) {
+            reply += productLine(*product) + "\n";
+        }
+        return reply;
+    }
+    if (command == "QUIT" || command == "SHUTDOWN") {
+        if (command == "SHUTDOWN") {
+            stopping.store(true);
+        }
+        return "OK BYE\n";
+    }
+    if (command == "CREATE") {
+        if (fields.size() < 6 || fields.size() > 7) {
+            return error("usage: CREATE media|good <name> <description> <a> <b> [price]");
+        }
+        Cents price = 0;
+        if (fields.size() == 7 && !Product::parsePrice(fields[6], price)) {
+            return error("invalid price");
+        }
+        std::string kind = fields[1];
+        std::transform(kind.begin(), kind.end(), kind.begin(), ::tolower);
+        Product* product = nullptr;
+        if (kind == "media") {
+            product = new Media(fields[2], fields[3], fields[4], fields[5], 0, 0, price);
+        } else if (kind == "good") {
+            int quantity;
+            if (!parseInt(fields[5], quantity) || quantity < 0) {
+                return error("invalid quantity");
+            }
+            product = new Good(fields[2], fields[3], fields[4], quantity, 0, 0, price);
+        } else {
+            return error("kind must be media or good");
+        }
+        if (!vendor.createProduct(product)) {
+            delete product;
+            return error("product not created");
+        }
+        return "OK " + std::to_string(product->getId()) + "\n";
+    }
+
+    // The rest address the kth product
+    if (command != "KTH" && command != "SELL" && command != "DELETE" && command != "MODIFY") {
+        return error("unknown command " + fields[0]);
+    }
+    int k;
+    if (fields.size() < 2 || !parseInt(fields[1], k)) {
+        return error("expected a product index");
+    }
+    if (k <= 0 || k > vendor.getProductCount()) {
+        return error("invalid product index; " + std::to_string(vendor.getProductCount()) + " products");
+    }
+
+    if (command == "KTH") {
+        return "OK " + productLine(*vendor.getKthProduct(k)) + "\n";
+    }
+    if (command == "SELL") {
+        int quantity;
+        if (fields.size() != 3 || !parseInt(fields[2], quantity) || quantity <= 0) {
+            return error("usage: SELL <k> <quantity>");
+        }
+        return vendor.sellProduct(k, quantity) ? "OK SOLD\n" : error("not enough inventory");
+    }
+    if (command == "DELETE") {
+        return vendor.deleteProduct(k) ? "OK DELETED\n" : error("product not deleted");
+    }
+    if (command == "MODIFY") {
+        if (fields.size() != 4) {
+            return error("usage: MODIFY <k> <field> <value>");
+        }
+        Product* product = vendor.getKthProduct(k);
+        std::string field = fields[2];
+        const std::string& value = fields[3];
+        std::transform(field.begin(), field.end(), field.begin(), ::tolower);
+        Media* media = dynamic_cast<Media*>(product);
+        Good* good = dynamic_cast<Good*>(product);
+        int number;
+        Cents price;
+        if (field == "name") {
+            product->setName(value);
+        } else if (field == "description") {
+            product->setDescription(value);
+        } else if (field == "rating") {
+            if (!parseInt(value, number) || number < 0 || number > 5) {
+                return error("rating must be 0-5");
+            }
+            product->setRating(number);
+        } else if (field == "price") {
+            if (!Product::parsePrice(value, price)) {
+                return error("invalid price");
+            }
+            product->setPrice(price);
+        } else if (field == "type" && media != nullptr) {
+            media->setType(value);
+        } else if (field == "audience" && media != nullptr) {
+            media->setTargetAudience(value);
+        } else if (field == "expiration" && good != nullptr) {
+            good->setExpirationDate(value);
+        } else if (field == "quantity" && good != nullptr) {
+            if (!parseInt(value, number) || number < 0) {
+                return error("invalid quantity");
+            }
+            good->setQuantity(number);
+        } else {
+            return error("unknown field for this product");
+        }
+        if (!vendor.publishProduct(product->getId())) {
+            return error("name already taken");
+        }
+        return "OK " + productLine(*product) + "\n";
+    }
+    return error("unknown command " + fields[0]);
+}
+
+// Counters
+int VendorServer::getPort() const {
+    return port;
+}
+
+std::size_t VendorServer::getConnectionCount() const {
+    return connections.size();
+}
+
+std::uint64_t VendorServer::getRequestsServed() const {
+    return requestsServed.load(std::memory_order_relaxed);
+}
+
+// Loop helpers
+bool VendorServer::prepareLoop() {
+    epollFd = epoll_create1(0);
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0) {
+        std::cout << "Error: Could not start the event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    return true;
+}
+
+void VendorServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EMFILE && errno != ENFILE) {
+                return; // EAGAIN: none left
+            }
+            // Out of descriptors: the listener stays readable, so shed the client rather than spin
+            if (spareFd >= 0) {
+                close(spareFd);
+                int shed = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+                if (shed >= 0) {
+                    close(shed);
+                }
+                spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                if (shed >= 0) {
+                    continue;
+                }
+            }
+            // No spare to shed with: stop listening until a client closes
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+            listenPaused = true;
+            return;
+        }
+        if (unixPath.empty()) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+        connections[fd] = Connection{std::string(), std::string(), 0, true, false, false, false};
+    }
+}
+
+bool VendorServer::readFrom(int fd, Connection& connection) {
+    char buffer[16 * 1024];
+    while (!connection.peerClosed && connection.input.size() < MAX_PENDING_INPUT) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<std::size_t>(received));
+            if (received < static_cast<ssize_t>(sizeof(buffer))) {
+                break;
+            }
+        } else if (received == 0) {
+            // A half-closed client still gets the replies to what it sent
+            connection.peerClosed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    return answerInput(fd, connection);
+}
+
+bool VendorServer::answerInput(int fd, Connection& connection) {
+    while (true) {
+        if (!processInput(connection)) {
+            flush(fd, connection);
+            return false;
+        }
+        if (!flush(fd, connection)) {
+            return false;
+        }
+        // Parsing stopped at MAX_PENDING_OUTPUT; if all of that was sent at once, no
+        // EPOLLOUT is armed and the requests left in input would never be answered
+        if (!connection.output.empty() || connection.closing || connection.input.find('\n') == std::string::npos) {
+            return true;
+        }
+    }
+}
+
+bool VendorServer::processInput(Connection& connection) {
+    std::size_t start = 0;
+    while (!connection.closing && connection.output.size() - connection.outputSent < MAX_PENDING_OUTPUT) {
+        std::size_t newline = connection.input.find('\n', start);
+        if (newline == std::string::npos) {
+            break;
+        }
+        std::size_t end = (newline > start && connection.input[newline - 1] == '\r') ? newline - 1 : newline;
+        std::string line = connection.input.substr(start, end - start);
+        start = newline + 1;
+
+        connection.output += handleRequest(line);
+        std::string command = line.substr(0, line.find_first_of(" \t"));
+        std::transform(command.begin(), command.end(), command.begin(), ::toupper);
+        if (command == "QUIT") {
+            connection.closing = true;
+        }
+    }
+    connection.input.erase(0, start);
+    if (connection.input.size() > MAX_LINE && connection.input.find('\n') == std::string::npos) {
+        connection.output += error("request too long");
+        connection.closing = true;
+        connection.input.clear();
+        return false;
+    }
+    return true;
+}
+
+bool VendorServer::flush(int fd, Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t sent = send(fd, connection.output.data() + connection.outputSent,
+                            connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.outputSent += static_cast<std::size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    bool pending = connection.outputSent < connection.output.size();
+    if (!pending) {
+        connection.output.clear();
+        connection.outputSent = 0;
+        bool answeredAll = connection.input.find('\n') == std::string::npos;
+        if (connection.closing || (connection.peerClosed && answeredAll)) {
+            return false;
+        }
+    }
+    // Only ask for EPOLLOUT while replies are waiting for socket space. Stop
+    // asking for EPOLLIN once the client has sent EOF, and while it is not
+    // reading its replies, so its requests wait in the kernel rather than here
+    bool readable = !connection.peerClosed
+        && connection.output.size() - connection.outputSent < MAX_PENDING_OUTPUT
+        && connection.input.size() < MAX_PENDING_INPUT;
+    if (pending != connection.wantsWrite || readable != connection.wantsRead) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = (readable ? static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP) : 0u)
+                     | (pending ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+        connection.wantsRead = readable;
+        connection.wantsWrite = pending;
+    }
+    return true;
+}
+
+void VendorServer::closeConnection(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+    if (listenPaused) {
+        // A descriptor is free again; take back the spare first, then resume accepting
+        if (spareFd < 0) {
+            spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        }
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+        listenPaused = false;
+    }
+}
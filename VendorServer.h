@@ -0,0 +1,216 @@
+#ifndef VENDOR_SERVER_H
+#define VENDOR_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Vendor.h"
+
+/**
+ * @brief Single-threaded epoll server exposing a Vendor over a line protocol
+ *
+ * Clients connect over TCP on 127.0.0.1 or over a Unix socket and send one
+ * request per line. Fields are separated by tabs; requests with no text
+ * fields may use spaces instead. Requests are answered in order, so a
+ * client may pipeline any number of them without waiting. Every reply is
+ * one line starting with "OK" or "ERR", except LIST, whose "OK n" line is
+ * followed by n product lines.
+ *
+ *     PING                                   -> OK PONG
+ *     COUNT                                  -> OK <products>
+ *     LIST                                   -> OK <n>, then n product lines
+ *     KTH <k>                                -> OK <product line>
+ *     CREATE media <name> <description> <type> <audience> [price]
+ *     CREATE good <name> <description> <expiration> <quantity> [price]
+ *                                            -> OK <id>
+ *     SELL <k> <quantity>                    -> OK SOLD | ERR ...
+ *     MODIFY <k> <field> <value>             -> OK <product line>
+ *         field: name, description, rating, price, type, audience, expiration, quantity
+ *     DELETE <k>                             -> OK DELETED
+ *     QUIT                                   -> OK BYE, then the connection closes
+ *     SHUTDOWN                               -> OK BYE, then run() returns
+ *
+ * A product line is id, "media" or "good", name, description, rating,
+ * price, sold count, then type and audience (media) or expiration and
+ * quantity (good), separated by tabs.
+ *
+ * All sockets are non-blocking and served from one thread, so thousands
+ * of idle or pipelining connections cost one small buffer pair each. The
+ * vendor must not be used by other threads while run() is serving.
+ */
+class VendorServer {
+public:
+    /**
+     * @brief Parameterized constructor
+     * @param vendor The vendor whose catalog is served
+     * @pre vendor outlives the server
+     * @post The server is created but not listening
+     */
+    explicit VendorServer(Vendor& vendor);
+
+    /**
+     * @brief Destructor
+     * @pre run() has returned
+     * @post All sockets are closed and a Unix socket file is removed
+     */
+    ~VendorServer();
+
+    VendorServer(const VendorServer&) = delete;
+    VendorServer& operator=(const VendorServer&) = delete;
+
+    /**
+     * @brief Listens on a TCP port of 127.0.0.1
+     * @param port The port, or 0 to let the system pick one
+     * @pre The server is not listening yet
+     * @post On success getPort() returns the bound port
+     * @return True if listening, false otherwise (an error is printed)
+     */
+    bool listenTcp(int port);
+
+    /**
+     * @brief Listens on a Unix socket
+     * @param path The socket file to create; an existing file there is replaced
+     * @pre The server is not listening yet
+     * @return True if listening, false otherwise (an error is printed)
+     */
+    bool listenUnix(const std::string& path);
+
+    /**
+     * @brief Serves connections until stop() or a SHUTDOWN request
+     * @pre listenTcp() or listenUnix() succeeded
+     * @post Every connection is closed
+     * @return True if the loop ran, false if it could not start
+     */
+    bool run();
+
+    /**
+     * @brief Asks run() to return
+     * @pre Safe to call from any thread
+     * @post run() returns after its current iteration
+     */
+    void stop();
+
+    /**
+     * @brief Executes one request line
+     * @param line The request, without its newline
+     * @return The reply, ending with a newline
+     */
+    std::string handleRequest(const std::string& line);
+
+    /**
+     * @brief Gets the TCP port the server is bound to
+     * @return The port, or 0 if not listening on TCP
+     */
+    int getPort() const;
+
+    /**
+     * @brief Gets the number of open client connections
+     * @return The connection count
+     */
+    std::size_t getConnectionCount() const;
+
+    /**
+     * @brief Gets the number of requests answered so far
+     * @pre Safe to call from any thread
+     * @return The request count
+     */
+    std::uint64_t getRequestsServed() const;
+
+private:
+    /// Per-client buffers
+    struct Connection {
+        std::string input;          ///< Received bytes not yet parsed into requests
+        std::string output;         ///< Replies not yet fully sent
+        std::size_t outputSent;     ///< Bytes of output already sent
+        bool wantsRead;             ///< Registered for EPOLLIN
+        bool wantsWrite;            ///< Registered for EPOLLOUT
+        bool closing;               ///< Close once output is sent (after QUIT or an error)
+        bool peerClosed;            ///< The client sent EOF; close once its requests are answered
+    };
+
+    static const std::size_t MAX_LINE = 64 * 1024;           ///< Longest accepted request
+    static const std::size_t MAX_PENDING_OUTPUT = 1 << 20;   ///< Stop parsing and reading while this much is unsent
+    static const std::size_t MAX_PENDING_INPUT = 1 << 20;    ///< Stop reading while this much is unparsed
+    static const int MAX_EVENTS = 256;                       ///< Events taken per epoll_wait
+
+    Vendor& vendor;                 ///< The served vendor
+    int listenFd;                   ///< Listening socket, or -1
+    int epollFd;                    ///< epoll instance, or -1
+    int wakeFd;                     ///< eventfd used by stop(), or -1
+    int spareFd;                    ///< Descriptor held in reserve to shed clients when out of descriptors, or -1
+    bool listenPaused;              ///< Listener removed from epoll until a client closes
+    int port;                       ///< Bound TCP port, or 0
+    std::string unixPath;           ///< Bound Unix socket path, or empty
+    std::atomic<bool> stopping;     ///< Set by stop() and SHUTDOWN
+    std::atomic<std::uint64_t> requestsServed; ///< Requests answered
+    std::unordered_map<int, Connection> connections; ///< Open clients by socket
+
+    /**
+     * @brief Creates the epoll instance and wake eventfd and registers the listener
+     * @return True on success, false otherwise
+     */
+    bool prepareLoop();
+
+    /**
+     * @brief Accepts every pending connection
+     *
+     * When the process is out of descriptors, the reserved spare is freed
+     * to accept and at once close each pending client, so the level-triggered
+     * listener does not keep waking the loop. If the spare cannot be taken
+     * back, the listener is paused until a client closes.
+     */
+    void acceptConnections();
+
+    /**
+     * @brief Reads what a client sent and answers complete requests
+     * @param fd The client socket
+     * @param connection The client's buffers
+     * @return False if the connection should be closed
+     */
+    bool readFrom(int fd, Connection& connection);
+
+    /**
+     * @brief Answers buffered requests until they are done or the client must catch up
+     *
+     * Alternates processInput() and flush() for as long as flush() sends
+     * everything and complete requests remain, since no event would
+     * otherwise wake the loop for them.
+     *
+     * @param fd The client socket
+     * @param connection The client's buffers
+     * @return False if the connection should be closed
+     */
+    bool answerInput(int fd, Connection& connection);
+
+    /**
+     * @brief Parses complete lines from the input buffer and queues their replies
+     * @param connection The client's buffers
+     * @return False if a request was too long
+     */
+    bool processInput(Connection& connection);
+
+    /**
+     * @brief Sends as much queued output as the socket accepts
+     *
+     * Also updates what the client is registered for: EPOLLOUT while replies
+     * wait for socket space, and EPOLLIN only while the unsent output and
+     * unparsed input are under their caps, so a client that does not read
+     * its replies stops being read until they drain.
+     *
+     * @param fd The client socket
+     * @param connection The client's buffers
+     * @return False if the connection should be closed
+     */
+    bool flush(int fd, Connection& connection);
+
+    /**
+     * @brief Closes a client and forgets its buffers
+     * @param fd The client socket
+     */
+    void closeConnection(int fd);
+};
+
+#endif // VENDOR_SERVER_H
@@ -0,0 +1,346 @@
+#include "VendorSession.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include "Stats.h"
+#include "Trace.h"
+#include "VendorServer.h"
+
+// Trace scopes below never span a co_await: sessions interleave on one thread,
+// and a scope left open across a suspension would nest inside another session's.
+
+VendorSession::VendorSession(Vendor& vendor, std::streambuf* output)
+    : Session(output), vendor(vendor), localServerAllowed(false) {}
+
+void VendorSession::setLocalServerAllowed(bool allowed) {
+    localServerAllowed = allowed;
+}
+
+// Menu loop
+SessionTask VendorSession::run() {
+    int choice = -1;
+    while (choice != 0) {
+        displayMenu();
+        if (!co_await readNumber(choice)) {
+            if (atEndOfInput()) {
+                std::cout << "Logging you out." << std::endl;
+                co_return true;
+            }
+            std::cout << "Invalid input. Please enter a number." << std::endl;
+            choice = -1;
+            continue;
+        }
+        co_await runChoice(choice);
+    }
+    co_return true;
+}
+
+// Dispatch lives in its own coroutine so its frame is freed between choices
+SessionTask VendorSession::runChoice(int choice) {
+    switch (choice) {
+        case 1: {
+            TRACE_SCOPE("menu.displayProfile");
+            vendor.displayProfile();
+            break;
+        }
+        case 2:
+            co_await modifyPassword();
+            break;
+        case 3:
+            co_await createProduct();
+            break;
+        case 4: {
+            TRACE_SCOPE("menu.displayAllProducts");
+            vendor.displayAllProducts();
+            break;
+        }
+        case 5:
+            co_await displayKthProduct();
+            break;
+        case 6:
+            co_await modifyProduct();
+            break;
+        case 7:
+            co_await sellProduct();
+            break;
+        case 8:
+            co_await deleteProduct();
+            break;
+        case 9: {
+            TRACE_SCOPE("menu.displayStats");
+            Stats::dump(std::cout);
+            vendor.displayMemoryUsage();
+            break;
+        }
+        case 10: {
+            TRACE_SCOPE("menu.displayMemoryUsage");
+            vendor.displayMemoryUsage();
+            break;
+        }
+        case 11:
+            co_await displayProductsSorted();
+            break;
+        case 12:
+            co_await startLocalServer();
+            break;
+        case 0:
+            std::cout << "Logging you out." << std::endl;
+            break;
+        default:
+            std::cout << "Invalid choice. Please try again." << std::endl;
+    }
+    co_return true;
+}
+
+void VendorSession::displayMenu() const {
+    std::cout << "\n Hi, " << vendor.getUsername() << ", what would you like to do:\n"
+              << "1. Display Profile\n"
+              << "2. Modify Password\n"
+              << "3. Create Product\n"
+              << "4. Display All Products\n"
+              << "5. Display Kth Product\n"
+              << "6. Modify Product\n"
+              << "7. Sell Product\n"
+              << "8. Delete Product\n"
+              << "9. Display Stats\n"
+              << "10. Display Memory Usage\n"
+              << "11. Display Products Sorted\n"
+              << "12. Start Local Server\n"
+              << "0. Logout\n"
+              << "Choice: ";
+}
+
+SessionTask VendorSession::readNumber(int& value) {
+    std::string word;
+    if (co_await readWord(word)) {
+        errno = 0;
+        char* end = nullptr;
+        long parsed = std::strtol(word.c_str(), &end, 10);
+        if (*end == '\0' && errno == 0 && parsed >= INT_MIN && parsed <= INT_MAX) {
+            value = static_cast<int>(parsed);
+            co_return true;
+        }
+    }
+    co_await skipLine();
+    co_return false;
+}
+
+// Menu actions
+SessionTask VendorSession::modifyPassword() {
+    std::string newPassword;
+    std::cout << "Enter new password: ";
+    co_await readWord(newPassword);
+
+    TRACE_SCOPE("menu.modifyPassword");
+    if (vendor.modifyPassword(newPassword)) {
+        std::cout << "Password updated successfully!" << std::endl;
+    }
+    co_return true;
+}
+
+SessionTask VendorSession::createProduct() {
+    int productType;
+    std::string name, description;
+
+    std::cout << "What type of product would you like to create?" << std::endl;
+    std::cout << "1. Media" << std::endl;
+    std::cout << "2. Goods" << std::endl;
+    std::cout << "Enter choice: ";
+    if (!co_await readNumber(productType)) {
+        std::cout << "Invalid input. Please try again." << std::endl;
+        co_return false;
+    }
+
+    skipChar();
+    std::cout << "Enter product name: ";
+    co_await readLine(name);
+
+    std::cout << "Enter product description: ";
+    co_await readLine(description);
+
+    Product* product = nullptr;
+    if (productType == 1) {
+        std::string type, targetAudience;
+        Cents price;
+
+        std::cout << "Enter media type (e.g., book, movie, music): ";
+        co_await readLine(type);
+
+        std::cout << "Enter target audience: ";
+        co_await readLine(targetAudience);
+
+        co_await readPrice(price);
+        product = new Media(name, description, type, targetAudience, 0, 0, price);
+    } else if (productType == 2) {
+        std::string expirationDate;
+        int quantity;
+        Cents price;
+
+        std::cout << "Enter expiration date: ";
+        co_await readLine(expirationDate);
+
+        std::cout << "Enter quantity: ";
+        if (co_await readNumber(quantity)) {
+            co_await skipLine();
+        } else {
+            std::cout << "Invalid quantity. Using default of 0." << std::endl;
+            quantity = 0;
+        }
+
+        co_await readPrice(price);
+        product = new Good(name, description, expirationDate, quantity, 0, 0, price);
+    } else {
+        std::cout << "Invalid product type." << std::endl;
+        co_return false;
+    }
+
+    TRACE_SCOPE("menu.createProduct");
+    if (vendor.createProduct(product)) {
+        std::cout << (productType == 1 ? "Media" : "Good") << " product created successfully!" << std::endl;
+        co_return true;
+    }
+    std::cout << "Failed to create " << (productType == 1 ? "media" : "good") << " product." << std::endl;
+    delete product; // Clean up if failed
+    co_return false;
+}
+
+SessionTask VendorSession::readPrice(Cents& price) {
+    std::string priceText;
+    std::cout << "Enter price (e.g. 19.99): ";
+    co_await readLine(priceText);
+    if (!Product::parsePrice(priceText, price)) {
+        std::cout << "Invalid price. Using default of 0.00." << std::endl;
+        price = 0;
+    }
+    co_return true;
+}
+
+SessionTask VendorSession::displayKthProduct() {
+    int k;
+    std::cout << "Enter the product index (k): ";
+    if (!co_await readNumber(k)) {
+        std::cout << "Invalid input. Please enter a number." << std::endl;
+        co_return false;
+    }
+
+    TRACE_SCOPE("menu.displayKthProduct");
+    vendor.displayProduct(k);
+    co_return true;
+}
+
+SessionTask VendorSession::modifyProduct() {
+    int index;
+    std::cout << "Enter the product index to modify: ";
+    if (!co_await readNumber(index)) {
+        std::cout << "Invalid input. Please enter a number." << std::endl;
+        co_return false;
+    }
+    skipChar();
+
+    Product* product = vendor.getKthProduct(index);
+    if (product == nullptr) {
+        co_return false;
+    }
+    ProductId id = product->getId();
+    for (int field = 0; field < product->getModifyFieldCount(); field++) {
+        std::string answer;
+        product->promptModifyField(field);
+        co_await readLine(answer);
+
+        product = vendor.getProductById(id);
+        if (product == nullptr) {
+            std::cout << "The product was deleted while it was being modified." << std::endl;
+            co_return false;
+        }
+        product->applyModifyField(field, answer);
+    }
+
+    TRACE_SCOPE("menu.modifyProduct");
+    // In unique-name mode a rename onto a taken name is undone, and the error says so
+    if (!vendor.publishProduct(id)) {
+        co_return false;
+    }
+    std::cout << "Product modified successfully!" << std::endl;
+    co_return true;
+}
+
+SessionTask VendorSession::sellProduct() {
+    int index;
+    std::cout << "Enter the product index to sell: ";
+    if (!co_await readNumber(index)) {
+        std::cout << "Invalid input. Please enter a number." << std::endl;
+        co_return false;
+    }
+
+    int quantity;
+    std::cout << "Enter quantity to sell: ";
+    if (!co_await readNumber(quantity)) {
+        std::cout << "Invalid quantity. Using 1 as default." << std::endl;
+        quantity = 1;
+    }
+
+    TRACE_SCOPE("menu.sellProduct");
+    co_return vendor.sellProduct(index, quantity);
+}
+
+SessionTask VendorSession::deleteProduct() {
+    int index;
+    std::cout << "Enter the product index to delete: ";
+    if (!co_await readNumber(index)) {
+        std::cout << "Invalid input. Please enter a number." << std::endl;
+        co_return false;
+    }
+
+    TRACE_SCOPE("menu.deleteProduct");
+    co_return vendor.deleteProduct(index);
+}
+
+SessionTask VendorSession::displayProductsSorted() {
+    int sortChoice;
+    std::cout << "Sort by:" << std::endl;
+    std::cout << "1. Rating" << std::endl;
+    std::cout << "2. Sold Count" << std::endl;
+    std::cout << "3. Name" << std::endl;
+    std::cout << "Enter choice: ";
+    bool valid = co_await readNumber(sortChoice);
+    if (valid && (sortChoice < 1 || sortChoice > 3)) {
+        co_await skipLine();
+        valid = false;
+    }
+    if (!valid) {
+        std::cout << "Invalid sort choice." << std::endl;
+        co_return false;
+    }
+
+    TRACE_SCOPE("menu.displayProductsSorted");
+    vendor.displayProductsSortedBy(static_cast<ProductSortKey>(sortChoice - 1));
+    co_return true;
+}
+
+SessionTask VendorSession::startLocalServer() {
+    std::string endpoint;
+    std::cout << "Enter a port number or Unix socket path: ";
+    co_await readWord(endpoint);
+
+    if (!localServerAllowed) {
+        std::cout << "The local server can only be started from the console." << std::endl;
+        co_return false;
+    }
+
+    TRACE_SCOPE("menu.startLocalServer");
+    VendorServer server(vendor);
+    bool isPort = endpoint.size() <= 5 && endpoint.find_first_not_of("0123456789") == std::string::npos;
+    bool listening = isPort ? server.listenTcp(std::atoi(endpoint.c_str())) : server.listenUnix(endpoint);
+    if (!listening) {
+        co_return false;
+    }
+    if (isPort) {
+        std::cout << "Serving on 127.0.0.1:" << server.getPort() << ". Send SHUTDOWN to return to the menu." << std::endl;
+    } else {
+        std::cout << "Serving on " << endpoint << ". Send SHUTDOWN to return to the menu." << std::endl;
+    }
+    server.run();
+    std::cout << "Server stopped after " << server.getRequestsServed() << " requests." << std::endl;
+    co_return true;
+}
@@ -0,0 +1,117 @@
+#ifndef VENDOR_SESSION_H
+#define VENDOR_SESSION_H
+
+#include <string>
+#include "Session.h"
+#include "Vendor.h"
+
+/**
+ * @brief The vendor menu as a coroutine session
+ *
+ * Runs the same dialogue as the console menu (profile, products, sells,
+ * stats, ...) but awaits every answer, so one thread can hold thousands
+ * of menus open at once. Each menu action runs as its own coroutine, and
+ * its frame is freed when the action finishes. A suspended session at the
+ * menu prompt therefore keeps only the small top-level frame alive.
+ *
+ * Sessions may share a vendor as long as they are driven from one thread.
+ * A product modified across several answers is looked up again after each
+ * one, in case another session deleted it meanwhile.
+ */
+class VendorSession : public Session {
+public:
+    /**
+     * @brief Parameterized constructor
+     * @param vendor The vendor the menu acts on
+     * @param output Where the menu prints, or nullptr to collect it for takeOutput()
+     * @pre vendor outlives the session
+     * @post The session is created; start() shows the menu
+     */
+    explicit VendorSession(Vendor& vendor, std::streambuf* output = nullptr);
+
+    /**
+     * @brief Allows menu option 12 (Start Local Server)
+     * @param allowed True to allow it
+     * @post Option 12 runs the server only if allowed. It blocks the driving
+     *       thread until a client sends SHUTDOWN, so it is off by default.
+     */
+    void setLocalServerAllowed(bool allowed);
+
+protected:
+    /**
+     * @brief The menu loop
+     * @return The coroutine that runs until logout or end of input
+     */
+    SessionTask run() override;
+
+private:
+    Vendor& vendor;             ///< The vendor acted on
+    bool localServerAllowed;    ///< Whether option 12 may block the thread
+
+    /**
+     * @brief Runs one menu choice
+     * @param choice The option number
+     */
+    SessionTask runChoice(int choice);
+
+    /**
+     * @brief Prints the menu
+     */
+    void displayMenu() const;
+
+    /**
+     * @brief Reads an integer word, like `std::cin >> value`
+     * @param value Receives the number
+     * @post On failure the rest of the line is discarded
+     * @return Coroutine yielding true if a number was read
+     */
+    SessionTask readNumber(int& value);
+
+    /**
+     * @brief Option 2: reads and sets a new password
+     */
+    SessionTask modifyPassword();
+
+    /**
+     * @brief Option 3: reads a new media product or good and adds it
+     */
+    SessionTask createProduct();
+
+    /**
+     * @brief Reads a price line for createProduct()
+     * @param price Receives the price, or 0 if the line is not a valid price
+     */
+    SessionTask readPrice(Cents& price);
+
+    /**
+     * @brief Option 5: reads an index and displays that product
+     */
+    SessionTask displayKthProduct();
+
+    /**
+     * @brief Option 6: reads an index, then prompts for each field of that product
+     */
+    SessionTask modifyProduct();
+
+    /**
+     * @brief Option 7: reads an index and a quantity and sells
+     */
+    SessionTask sellProduct();
+
+    /**
+     * @brief Option 8: reads an index and deletes that product
+     */
+    SessionTask deleteProduct();
+
+    /**
+     * @brief Option 11: reads a sort key and displays the products in that order
+     */
+    SessionTask displayProductsSorted();
+
+    /**
+     * @brief Option 12: reads an endpoint and serves the vendor until SHUTDOWN
+     */
+    SessionTask startLocalServer();
+};
+
+#endif // VENDOR_SESSION_H
@@ -0,0 +1,176 @@
+// LinkedBag::contains() misses with and without a counting Bloom filter, for
+// several target false-positive rates: configured, predicted and observed
+// rates, filter memory, the O(1) filter check, and the average cost of a
+// miss (including the chain walks false positives still pay), a hit and an add.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/BagFilterBench.cpp Trace.cpp -o bagFilterBench
+// Usage: bagFilterBench [--elements N] [--queries Q] [--rate P] [--seed X]
+//   The bag holds N distinct even numbers; misses look up odd numbers.
+//   Without --rate the filter is tried at 10%, 1% and 0.1%.
+//   The exit status is 1 if the filter ever hides an entry that is present.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../LinkedBagDS/LinkedBag.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct Config {
+    int elements = 1000000;
+    int queries = 20000;
+    double rate = 0.0;
+    uint64_t seed = 42;
+};
+
+// SplitMix64, as in the load generator
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+// Nanoseconds per contains() over the given keys; counts the keys found
+double timeContains(const LinkedBag<int>& bag, const vector<int>& keys, int& found) {
+    found = 0;
+    Clock::time_point start = Clock::now();
+    for (int key : keys) {
+        found += bag.contains(key) ? 1 : 0;
+    }
+    return chrono::duration<double, nano>(Clock::now() - start).count() / keys.size();
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--elements") {
+            config.elements = max(1, atoi(value));
+        } else if (flag == "--queries") {
+            config.queries = max(1, atoi(value));
+        } else if (flag == "--rate") {
+            config.rate = atof(value);
+        } else if (flag == "--seed") {
+            config.seed = strtoull(value, nullptr, 10);
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+
+    Random random(config.seed);
+    vector<int> values(config.elements);
+    for (int i = 0; i < config.elements; i++) {
+        values[i] = 2 * i;
+    }
+    // Shuffle so the chain order says nothing about the values
+    for (int i = config.elements - 1; i > 0; i--) {
+        swap(values[i], values[random.next() % (i + 1)]);
+    }
+
+    LinkedBag<int> bag;
+    Clock::time_point addStart = Clock::now();
+    for (int value : values) {
+        bag.add(value);
+    }
+    double addNanos = chrono::duration<double, nano>(Clock::now() - addStart).count() / config.elements;
+
+    vector<int> misses(config.queries);
+    for (int& key : misses) {
+        key = 2 * static_cast<int>(random.next() % config.elements) + 1;
+    }
+    vector<int> hits(min(config.queries, 200));
+    for (int& key : hits) {
+        key = values[random.next() % values.size()];
+    }
+
+    // The chain walk is slow enough that a small sample of misses suffices
+    vector<int> sample(misses.begin(), misses.begin() + min<size_t>(misses.size(), 200));
+    int found = 0;
+    double plainMiss = timeContains(bag, sample, found);
+    double plainHit = timeContains(bag, hits, found);
+    bool correct = found == static_cast<int>(hits.size());
+
+    cout << config.elements << " elements; without a filter: miss " << fixed << setprecision(0) << plainMiss
+         << " ns, hit " << plainHit << " ns, add " << setprecision(1) << addNanos << " ns" << endl;
+    cout << endl;
+    cout << setw(8) << "target" << setw(10) << "expected" << setw(10) << "observed" << setw(8) << "hashes"
+         << setw(12) << "filter MB" << setw(10) << "check ns" << setw(12) << "miss ns" << setw(10) << "speedup"
+         << setw(12) << "hit ns" << setw(10) << "add ns" << endl;
+
+    vector<double> rates = (config.rate > 0.0) ? vector<double>{config.rate} : vector<double>{0.1, 0.01, 0.001};
+    for (double rate : rates) {
+        LinkedBag<int> filtered;
+        filtered.enableMembershipFilter(rate, config.elements);
+        Clock::time_point start = Clock::now();
+        for (int value : values) {
+            filtered.add(value);
+        }
+        double filteredAdd = chrono::duration<double, nano>(Clock::now() - start).count() / config.elements;
+
+        double filteredMiss = timeContains(filtered, misses, found);
+        correct = correct && found == 0;
+        double filteredHit = timeContains(filtered, hits, found);
+        correct = correct && found == static_cast<int>(hits.size());
+
+        // The O(1) part of a miss: the filter check alone, on an identical filter
+        CountingBloomFilter<int> check(config.elements, rate);
+        for (int value : values) {
+            check.add(value);
+        }
+        int passed = 0;
+        start = Clock::now();
+        for (int key : misses) {
+            passed += check.mightContain(key) ? 1 : 0;
+        }
+        double checkNanos = chrono::duration<double, nano>(Clock::now() - start).count() / misses.size();
+
+        BagFilterStats stats = filtered.getMembershipFilterStats();
+        correct = correct && passed == stats.falsePositives;
+        cout << setw(7) << setprecision(1) << rate * 100 << "%" << setw(9) << setprecision(2)
+             << stats.expectedRate * 100 << "%" << setw(9) << stats.observedRate * 100 << "%"
+             << setw(8) << stats.hashCount << setw(12) << setprecision(1) << stats.counterBytes / 1e6
+             << setw(10) << setprecision(0) << checkNanos
+             << setw(12) << filteredMiss << setw(9) << setprecision(0)
+             << plainMiss / filteredMiss << "x" << setw(12) << filteredHit << setw(10) << setprecision(1)
+             << filteredAdd << endl;
+    }
+
+    if (!correct) {
+        cout << "Filter FAILED" << endl;
+    }
+    return correct ? 0 : 1;
+}
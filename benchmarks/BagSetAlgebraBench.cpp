@@ -0,0 +1,106 @@
+// LinkedBag intersection/difference/unionWith against the nested contains()/remove() approach.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/BagSetAlgebraBench.cpp Trace.cpp -o bagSetAlgebraBench
+// Usage: bagSetAlgebraBench [maxItems]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../LinkedBagDS/LinkedBag.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+// What the bag offered before: probe a scratch copy of the other bag per item
+LinkedBag<int> naiveIntersection(const LinkedBag<int>& first, const LinkedBag<int>& second) {
+    LinkedBag<int> remaining(second);
+    LinkedBag<int> result;
+    for (int entry : first.toVector()) {
+        if (remaining.remove(entry)) {
+            result.add(entry);
+        }
+    }
+    return result;
+}
+
+LinkedBag<int> naiveDifference(const LinkedBag<int>& first, const LinkedBag<int>& second) {
+    LinkedBag<int> remaining(second);
+    LinkedBag<int> result;
+    for (int entry : first.toVector()) {
+        if (!remaining.remove(entry)) {
+            result.add(entry);
+        }
+    }
+    return result;
+}
+
+LinkedBag<int> naiveUnion(const LinkedBag<int>& first, const LinkedBag<int>& second) {
+    LinkedBag<int> remaining(first);
+    LinkedBag<int> result(first);
+    for (int entry : second.toVector()) {
+        if (!remaining.remove(entry)) {
+            result.add(entry);
+        }
+    }
+    return result;
+}
+
+template<class Fn>
+double timeMicros(Fn fn, int& checksum) {
+    // Repeat small inputs so the timer has something to measure
+    int repeats = 0;
+    Clock::time_point start = Clock::now();
+    Clock::duration elapsed;
+    do {
+        checksum += fn().getCurrentSize();
+        repeats++;
+        elapsed = Clock::now() - start;
+    } while (elapsed < chrono::milliseconds(50));
+    return chrono::duration<double, micro>(elapsed).count() / repeats;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxItems = argc > 1 ? atoi(argv[1]) : 20000;
+
+    cout << setw(8) << "items" << setw(10) << "op" << setw(16) << "naive us"
+         << setw(16) << "hashed us" << setw(10) << "speedup" << endl;
+    cout << fixed << setprecision(1);
+
+    int checksum = 0;
+    for (int items = 10; items <= maxItems; items *= 10) {
+        // Half the values overlap and every value repeats, so multiplicity matters
+        LinkedBag<int> first;
+        LinkedBag<int> second;
+        unsigned seed = 2024;
+        for (int i = 0; i < items; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            first.add(static_cast<int>((seed >> 8) % (items / 2 + 1)));
+            seed = seed * 1664525u + 1013904223u;
+            second.add(static_cast<int>((seed >> 8) % (items / 2 + 1)) + items / 4);
+        }
+
+        double naive = timeMicros([&] { return naiveIntersection(first, second); }, checksum);
+        double hashed = timeMicros([&] { return first.intersection(second); }, checksum);
+        cout << setw(8) << items << setw(10) << "and" << setw(16) << naive
+             << setw(16) << hashed << setw(10) << naive / hashed << endl;
+
+        naive = timeMicros([&] { return naiveDifference(first, second); }, checksum);
+        hashed = timeMicros([&] { return first.difference(second); }, checksum);
+        cout << setw(8) << items << setw(10) << "minus" << setw(16) << naive
+             << setw(16) << hashed << setw(10) << naive / hashed << endl;
+
+        naive = timeMicros([&] { return naiveUnion(first, second); }, checksum);
+        hashed = timeMicros([&] { return first.unionWith(second); }, checksum);
+        cout << setw(8) << items << setw(10) << "or" << setw(16) << naive
+             << setw(16) << hashed << setw(10) << naive / hashed << endl;
+    }
+    return checksum == -1 ? 1 : 0;
+}
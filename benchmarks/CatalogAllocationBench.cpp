@@ -0,0 +1,147 @@
+// Heap allocations made by read-only catalog paths: listing, searching, name
+// lookups and comparisons, next to copying every string field out by value.
+//
+// Build from the repository root:
+//   g++ -std=c++20 -O2 -pthread benchmarks/CatalogAllocationBench.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o catalogAllocationBench
+// Usage: catalogAllocationBench [products]
+//   Every path except "copy fields" should report zero allocations; the exit
+//   status is 1 if one of them allocates. Each path runs once before it is counted.
+//   Built as C++17, name lookups copy the key: unordered_map::find() takes
+//   a std::string_view only from C++20 on.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+atomic<size_t> allocations(0);
+atomic<size_t> allocatedBytes(0);
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct Counted {
+    size_t allocations;
+    size_t bytes;
+};
+
+// Runs a path once to warm it up, then again while counting
+template<typename Path>
+Counted count(Path path) {
+    path();
+    size_t startAllocations = allocations.load();
+    size_t startBytes = allocatedBytes.load();
+    path();
+    return Counted{allocations.load() - startAllocations, allocatedBytes.load() - startBytes};
+}
+
+} // namespace
+
+// Every allocation in the process goes through these. Kept out of line so the
+// compiler does not pair an inlined malloc() with another allocator's free().
+[[gnu::noinline]] void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    if (void* block = malloc(size == 0 ? 1 : size)) {
+        return block;
+    }
+    throw bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* block) noexcept {
+    free(block);
+}
+
+[[gnu::noinline]] void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+int main(int argc, char* argv[]) {
+    int productCount = (argc > 1) ? max(1, atoi(argv[1])) : 10000;
+
+    // Names and descriptions longer than the small-string buffer, as in a real catalog
+    Vendor vendor("bench", "bench@example.com", "secret", "Allocation bench vendor", "pic.png");
+    for (int p = 0; p < productCount; p++) {
+        string name = "Catalog product number " + to_string(p) + " with a long name";
+        string description = "Description of product " + to_string(p) + (p % 10 == 0 ? " (clearance)" : "")
+                           + ", long enough that no string implementation stores it inline.";
+        if (p % 2 == 0) {
+            vendor.createProduct(new Media(name, description, "book", "adults", p % 6, 0, 999));
+        } else {
+            vendor.createProduct(new Good(name, description, "2030-01-01", 50, p % 6, 0, 499));
+        }
+    }
+    vector<Product*> products = vendor.getProducts();
+
+    NullBuffer discard;
+    streambuf* savedOut = cout.rdbuf(&discard);
+
+    vector<Product*> matches;
+    size_t hits = 0;
+    Counted list = count([&] { vendor.displayAllProducts(); });
+    Counted sortedList = count([&] { vendor.displayProductsSortedBy(ProductSortKey::Name); });
+    Counted search = count([&] { hits += vendor.searchProducts("clearance", matches); });
+    Counted lookup = count([&] {
+        for (Product* product : products) {
+            hits += vendor.hasProductNamed(product->getName()) ? 1 : 0;
+        }
+    });
+    Counted compare = count([&] {
+        for (size_t i = 1; i < products.size(); i++) {
+            hits += (*products[i - 1] == *products[i]) ? 1 : 0;
+            hits += (products[i - 1]->getName() < products[i]->getName()) ? 1 : 0;
+        }
+    });
+    // What every read cost when the getters returned std::string by value
+    Counted copy = count([&] {
+        for (Product* product : products) {
+            string name(product->getName());
+            string description(product->getDescription());
+            hits += name.size() + description.size();
+        }
+    });
+
+    cout.rdbuf(savedOut);
+
+    struct Row {
+        const char* path;
+        Counted counted;
+        bool mustBeZero;
+    };
+    const Row rows[] = {
+        {"list", list, true},
+        {"sorted list", sortedList, true},
+        {"search", search, true},
+        {"name lookup", lookup, true},
+        {"compare", compare, true},
+        {"copy fields", copy, false},
+    };
+
+    cout << "Products: " << productCount << " (search matched " << matches.size() << ")" << endl;
+    cout << setw(14) << "path" << setw(14) << "allocations" << setw(14) << "bytes" << setw(14) << "per product" << endl;
+    bool clean = true;
+    for (const Row& row : rows) {
+        cout << setw(14) << row.path << setw(14) << row.counted.allocations << setw(14) << row.counted.bytes
+             << setw(14) << fixed << setprecision(2)
+             << static_cast<double>(row.counted.allocations) / productCount << endl;
+        if (row.mustBeZero && row.counted.allocations != 0) {
+            clean = false;
+        }
+    }
+    return (clean && hits > 0) ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Read throughput of catalog snapshots at 1..N reader threads while a writer keeps publishing,
+// after the cost of a single publish with no readers.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/CatalogSnapshotBench.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o catalogSnapshotBench
+// Usage: catalogSnapshotBench [products] [millisPerRun] [maxReaders]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Vendor.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    int productCount = argc > 1 ? atoi(argv[1]) : 10000;
+    int millisPerRun = argc > 2 ? atoi(argv[2]) : 1000;
+    int maxReaders = argc > 3 ? atoi(argv[3]) : static_cast<int>(thread::hardware_concurrency());
+    if (maxReaders <= 0) {
+        maxReaders = 1;
+    }
+
+    Vendor vendor("bench", "bench@example.com", "secret", "bench vendor", "pic.png");
+    vector<ProductId> ids;
+    for (int p = 0; p < productCount; p++) {
+        Product* product = (p % 2 == 0)
+            ? static_cast<Product*>(new Media("media" + to_string(p), "a media product", "book", "all"))
+            : static_cast<Product*>(new Good("good" + to_string(p), "a physical good", "2030-01-01", 100));
+        vendor.createProduct(product);
+        ids.push_back(product->getId());
+    }
+
+    vector<int> readerCounts;
+    for (int readers = 1; readers < maxReaders; readers *= 2) {
+        readerCounts.push_back(readers);
+    }
+    readerCounts.push_back(maxReaders);
+
+    // One publish copies a root-to-leaf path, so its cost grows with log(products)
+    const int publishes = 20000;
+    chrono::steady_clock::time_point publishStart = chrono::steady_clock::now();
+    for (int i = 0; i < publishes; i++) {
+        vendor.publishProduct(ids[(i * 7919u) % ids.size()]);
+    }
+    double publishMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - publishStart).count() / publishes;
+
+    cout << productCount << " products, " << millisPerRun << " ms per run, 1 writer" << endl;
+    cout << "publishProduct: " << fixed << setprecision(2) << publishMicros << " us with no readers" << endl;
+    cout << setw(8) << "readers" << setw(16) << "scans/s" << setw(18) << "records/s"
+         << setw(14) << "writes/s" << setw(10) << "scaling" << endl;
+    cout << fixed << setprecision(0);
+
+    double baseline = 0.0;
+    for (int readers : readerCounts) {
+        atomic<bool> running(true);
+        atomic<uint64_t> scans(0);
+        atomic<uint64_t> writes(0);
+
+        // Writer: bump sold counts and publish, as a sell path would
+        thread writer([&] {
+            uint32_t seed = 12345;
+            uint64_t done = 0;
+            while (running.load(memory_order_relaxed)) {
+                seed = seed * 1664525u + 1013904223u;
+                ProductId id = ids[(seed >> 8) % ids.size()];
+                Product* product = vendor.getProductById(id);
+                product->setSoldCount(product->getSoldCount() + 1);
+                vendor.publishProduct(id);
+                done++;
+            }
+            writes.store(done);
+        });
+
+        vector<thread> threads;
+        for (int r = 0; r < readers; r++) {
+            threads.emplace_back([&] {
+                uint64_t done = 0;
+                long long checksum = 0;
+                while (running.load(memory_order_relaxed)) {
+                    shared_ptr<const CatalogSnapshot> snapshot = vendor.getCatalogSnapshot();
+                    snapshot->forEach([&checksum](const ProductRecord& record) {
+                        checksum += record.soldCount;
+                    });
+                    done++;
+                }
+                scans.fetch_add(done + (checksum == -1 ? 1 : 0));
+            });
+        }
+
+        this_thread::sleep_for(chrono::milliseconds(millisPerRun));
+        running.store(false);
+        for (thread& t : threads) {
+            t.join();
+        }
+        writer.join();
+
+        double seconds = millisPerRun / 1000.0;
+        double scansPerSecond = scans.load() / seconds;
+        if (readers == 1) {
+            baseline = scansPerSecond;
+        }
+        cout << setw(8) << readers << setw(16) << scansPerSecond
+             << setw(18) << scansPerSecond * productCount << setw(14) << writes.load() / seconds
+             << setw(10) << setprecision(2) << scansPerSecond / baseline << setprecision(0) << endl;
+    }
+    return 0;
+}
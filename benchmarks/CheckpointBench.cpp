@@ -0,0 +1,297 @@
+// Background checkpoints: how long a checkpoint of a large catalog takes, and
+// how much it adds to the latency of sells and product creation that keep
+// running while it is written, compared with stopping the world to write it.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/CheckpointBench.cpp Checkpoint.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o checkpointBench
+// Usage: checkpointBench [--vendors V] [--products N] [--operations K] [--rate BYTES_PER_SEC] [--path FILE] [--seed X]
+//   N products are spread over V vendors. One operation in 16 creates a
+//   product; the rest sell one unit of a random product by ID. Background
+//   checkpoints run once unlimited and once limited to --rate bytes per second.
+//   The exit status is 1 if a checkpoint fails or does not hold every product.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "../Checkpoint.h"
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct Config {
+    int vendors = 4;
+    int products = 200000;
+    int operations = 200000;
+    size_t rate = 16000000;
+    string path = "/tmp/amazon340.checkpoint";
+    uint64_t seed = 42;
+};
+
+// SplitMix64, as in the load generator
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+string makeText(Random& random, size_t length) {
+    static const char* const words[] = {"fresh", "durable", "classic", "limited", "organic", "premium",
+                                        "compact", "deluxe", "portable", "vintage", "smart", "handmade"};
+    string text;
+    while (text.size() < length) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += words[random.next() % 12];
+    }
+    text.resize(length);
+    return text;
+}
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+class Marketplace {
+public:
+    explicit Marketplace(const Config& config) : random(config.seed), created(0) {
+        for (int v = 0; v < config.vendors; v++) {
+            string name = "vendor" + to_string(v);
+            vendors.push_back(make_unique<Vendor>(name, name + "@example.com", "secret",
+                                                  makeText(random, 300), "pic.png"));
+            ids.emplace_back();
+        }
+        for (int p = 0; p < config.products; p++) {
+            create();
+        }
+    }
+
+    // One create or sell, returning its latency in nanoseconds
+    uint64_t operate() {
+        Clock::time_point start = Clock::now();
+        if (random.next() % 16 == 0) {
+            create();
+        } else {
+            size_t v = random.next() % vendors.size();
+            vendors[v]->sellProductById(ids[v][random.next() % ids[v].size()], 1);
+        }
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    vector<const Vendor*> getVendors() const {
+        vector<const Vendor*> result;
+        for (const unique_ptr<Vendor>& vendor : vendors) {
+            result.push_back(vendor.get());
+        }
+        return result;
+    }
+
+    size_t getProductCount() const {
+        size_t total = 0;
+        for (const vector<ProductId>& list : ids) {
+            total += list.size();
+        }
+        return total;
+    }
+
+private:
+    Random random;
+    vector<unique_ptr<Vendor> > vendors;
+    vector<vector<ProductId> > ids;
+    int created;
+
+    void create() {
+        size_t v = created % vendors.size();
+        string name = "Product " + to_string(created++);
+        string description = makeText(random, 100 + random.next() % 400);
+        Product* product = (created % 2 == 0)
+            ? static_cast<Product*>(new Media(name, description, "book", "all", created % 6, 0, 999))
+            : static_cast<Product*>(new Good(name, description, "2030-01-01", 1 << 30, created % 6, 0, 499));
+        vendors[v]->createProduct(product);
+        ids[v].push_back(product->getId());
+    }
+};
+
+struct Latencies {
+    vector<uint64_t> nanos;
+
+    uint64_t percentile(double fraction) {
+        if (nanos.empty()) {
+            return 0;
+        }
+        sort(nanos.begin(), nanos.end());
+        return nanos[min(nanos.size() - 1, static_cast<size_t>(fraction * nanos.size()))];
+    }
+};
+
+void printLatencies(const char* label, Latencies& latencies) {
+    cout << setw(26) << label << setw(10) << latencies.nanos.size() << setw(10) << latencies.percentile(0.5)
+         << setw(10) << latencies.percentile(0.99) << setw(10) << latencies.percentile(0.999)
+         << setw(12) << latencies.percentile(1.0) << endl;
+}
+
+// Checks the END line against the expected counts, and each vendor's
+// revenue against the products written after it (bench texts hold no newlines)
+bool verifyImage(const string& path, size_t vendors, size_t products) {
+    ifstream in(path, ios::binary);
+    string line, last;
+    long long expectedRevenue = 0, revenue = 0;
+    bool consistent = true;
+    while (getline(in, line)) {
+        istringstream fields(line);
+        string tag, kind;
+        unsigned long long number;
+        long long price;
+        int rating, sold;
+        fields >> tag;
+        if (tag == "V" || tag == "END") {
+            consistent = consistent && revenue == expectedRevenue;
+            fields >> number >> number >> expectedRevenue;
+            revenue = 0;
+        } else if (tag == "P" && fields >> number >> kind >> rating >> price >> sold) {
+            revenue += price * sold;
+        }
+        last = line;
+    }
+    ostringstream expected;
+    expected << "END " << vendors << " " << products;
+    return consistent && last == expected.str();
+}
+
+struct BackgroundRun {
+    Latencies latencies;
+    CheckpointStats stats;
+    double millis = 0.0;
+    bool correct = true;
+};
+
+// Starts a checkpoint and keeps operating until it completes
+BackgroundRun runInBackground(Marketplace& marketplace, const Config& config, size_t rate) {
+    BackgroundRun run;
+    Checkpoint checkpoint;
+    size_t products = marketplace.getProductCount();
+    Clock::time_point start = Clock::now();
+    run.correct = checkpoint.start(marketplace.getVendors(), config.path, rate);
+    while (checkpoint.isRunning()) {
+        run.latencies.nanos.push_back(marketplace.operate());
+    }
+    run.correct = checkpoint.wait() && run.correct;
+    run.millis = chrono::duration<double, milli>(Clock::now() - start).count();
+    run.correct = verifyImage(config.path, config.vendors, products) && run.correct;
+    run.stats = checkpoint.getStats();
+    return run;
+}
+
+void printRun(const char* label, const BackgroundRun& run) {
+    cout << label << " " << run.millis << " ms total; capture " << run.stats.captureNanos / 1000.0
+         << " us on the caller, write and sync " << run.stats.writeNanos / 1e6 << " ms ("
+         << run.stats.bytes / (run.stats.writeNanos / 1e9) / 1e6 << " MB/s)" << endl;
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--vendors") {
+            config.vendors = max(1, atoi(value));
+        } else if (flag == "--products") {
+            config.products = max(1, atoi(value));
+        } else if (flag == "--operations") {
+            config.operations = max(1, atoi(value));
+        } else if (flag == "--rate") {
+            config.rate = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (flag == "--path") {
+            config.path = value;
+        } else if (flag == "--seed") {
+            config.seed = strtoull(value, nullptr, 10);
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+
+    NullBuffer discard;
+    streambuf* savedOut = cout.rdbuf(&discard);
+    Marketplace marketplace(config);
+    bool correct = true;
+
+    // Without a checkpoint
+    Latencies idle;
+    for (int op = 0; op < config.operations; op++) {
+        idle.nanos.push_back(marketplace.operate());
+    }
+
+    // Stopping the world: every operation waits for the whole write
+    Checkpoint blocking;
+    size_t blockingProducts = marketplace.getProductCount();
+    Clock::time_point pauseStart = Clock::now();
+    correct = blocking.start(marketplace.getVendors(), config.path) && blocking.wait() && correct;
+    double pauseMillis = chrono::duration<double, milli>(Clock::now() - pauseStart).count();
+    correct = verifyImage(config.path, config.vendors, blockingProducts) && correct;
+
+    // In the background, operating until the checkpoint completes
+    BackgroundRun unlimited = runInBackground(marketplace, config, 0);
+    BackgroundRun limited = runInBackground(marketplace, config, config.rate);
+    correct = unlimited.correct && limited.correct && correct;
+    cout.rdbuf(savedOut);
+
+    cout << unlimited.stats.products << " products over " << unlimited.stats.vendors << " vendors; checkpoint file "
+         << unlimited.stats.bytes / 1000000.0 << " MB" << endl;
+    cout << endl;
+    cout << setw(26) << "operation latency (ns)" << setw(10) << "ops" << setw(10) << "p50" << setw(10) << "p99"
+         << setw(10) << "p99.9" << setw(12) << "max" << endl;
+    printLatencies("no checkpoint", idle);
+    printLatencies("during checkpoint", unlimited.latencies);
+    printLatencies("during rate-limited", limited.latencies);
+    cout << endl;
+    cout << fixed << setprecision(1);
+    cout << "Stop-the-world checkpoint: " << pauseMillis << " ms with every operation paused" << endl;
+    printRun("Background checkpoint:    ", unlimited);
+    printRun("Rate-limited checkpoint:  ", limited);
+
+    remove(config.path.c_str());
+    if (!correct) {
+        cout << "Checkpoint FAILED" << endl;
+    }
+    return correct ? 0 : 1;
+}
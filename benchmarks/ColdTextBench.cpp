@@ -0,0 +1,184 @@
+// Hot/cold split: memory held by product descriptions with and without a cold
+// text budget, the sell path before and after paging them out, and the cost
+// of displaying products whose description must be paged back in.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/ColdTextBench.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o coldTextBench
+// Usage: coldTextBench [--products N] [--budget BYTES] [--displays D] [--seed X]
+//   Descriptions have log-uniform lengths from 20 to 2000 characters.
+//   Displays pick products uniformly, so nearly every one misses the budget.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "../ColdText.h"
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct Config {
+    int products = 100000;
+    size_t budget = 1 << 20;
+    int displays = 20000;
+    uint64_t seed = 42;
+};
+
+// SplitMix64, as in the load generator
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Log-uniform in [low, high)
+    int skewedLength(int low, int high) {
+        double unit = (next() >> 11) * (1.0 / 9007199254740992.0);
+        return static_cast<int>(low * pow(static_cast<double>(high) / low, unit));
+    }
+
+private:
+    uint64_t state;
+};
+
+string makeText(Random& random, int length) {
+    static const char* const words[] = {"fresh", "durable", "classic", "limited", "organic", "premium",
+                                        "compact", "deluxe", "portable", "vintage", "smart", "handmade"};
+    string text;
+    while (static_cast<int>(text.size()) < length) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += words[random.next() % 12];
+    }
+    text.resize(length);
+    return text;
+}
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+// Sells one unit of every product directly (the hot path, without the
+// vendor's snapshot publishing) and returns nanoseconds per sell
+double sellAll(const vector<Product*>& products) {
+    Clock::time_point start = Clock::now();
+    for (Product* product : products) {
+        product->sell(1);
+    }
+    return chrono::duration<double, nano>(Clock::now() - start).count() / products.size();
+}
+
+void printStore(const char* label) {
+    ColdTextStats stats = ColdTextStore::getStats();
+    cout << setw(22) << label << setw(14) << stats.residentBytes << setw(14) << stats.pagedOutBytes
+         << setw(12) << stats.pageIns << setw(12) << stats.evictions << endl;
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--products") {
+            config.products = max(1, atoi(value));
+        } else if (flag == "--budget") {
+            config.budget = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (flag == "--displays") {
+            config.displays = max(0, atoi(value));
+        } else if (flag == "--seed") {
+            config.seed = strtoull(value, nullptr, 10);
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+
+    Random random(config.seed);
+    Vendor vendor("bench", "bench@example.com", "secret", makeText(random, 400), "pic.png");
+    vector<ProductId> ids;
+    size_t descriptionBytes = 0;
+    for (int p = 0; p < config.products; p++) {
+        string name = "Product " + to_string(p);
+        string description = makeText(random, random.skewedLength(20, 2000));
+        descriptionBytes += description.size();
+        Product* product = (p % 2 == 0)
+            ? static_cast<Product*>(new Media(name, description, "book", "all", p % 6, 0, 999))
+            : static_cast<Product*>(new Good(name, description, "2030-01-01", 1 << 30, p % 6, 0, 499));
+        vendor.createProduct(product);
+        ids.push_back(product->getId());
+    }
+
+    NullBuffer discard;
+    streambuf* savedOut = cout.rdbuf(&discard);
+    double sellAllResident = sellAll(vendor.getProducts());
+    cout.rdbuf(savedOut);
+
+    cout << config.products << " products, " << descriptionBytes << " description bytes ("
+         << descriptionBytes / config.products << " per product)" << endl;
+    cout << "sizeof: Media " << sizeof(Media) << ", Good " << sizeof(Good) << ", ColdText " << sizeof(ColdText)
+         << "; hot product bytes (footprint without cold text): "
+         << vendor.getMemoryFootprint().total() / config.products << " per product" << endl;
+    cout << endl;
+    cout << setw(22) << "" << setw(14) << "resident" << setw(14) << "paged out"
+         << setw(12) << "page-ins" << setw(12) << "evictions" << endl;
+    printStore("no budget");
+
+    Clock::time_point pageOutStart = Clock::now();
+    ColdTextStore::setBudget(config.budget);
+    double pageOutMillis = chrono::duration<double, milli>(Clock::now() - pageOutStart).count();
+    printStore("budget applied");
+
+    savedOut = cout.rdbuf(&discard);
+    double sellPagedOut = sellAll(vendor.getProducts());
+    Clock::time_point displayStart = Clock::now();
+    for (int d = 0; d < config.displays; d++) {
+        vendor.displayProductById(ids[random.next() % ids.size()]);
+    }
+    double displayNanos = chrono::duration<double, nano>(Clock::now() - displayStart).count();
+    cout.rdbuf(savedOut);
+    printStore("after displays");
+
+    ColdTextStats stats = ColdTextStore::getStats();
+    cout << endl;
+    cout << fixed << setprecision(1);
+    cout << "Budget:                " << config.budget << " bytes; paging out took " << pageOutMillis << " ms" << endl;
+    cout << "Description residency: " << static_cast<double>(descriptionBytes) / max<size_t>(1, stats.residentBytes)
+         << "x smaller (" << stats.fileBytes << " bytes in the backing file)" << endl;
+    cout << "Product::sell:         " << sellAllResident << " ns resident, " << sellPagedOut << " ns paged out" << endl;
+    if (config.displays > 0) {
+        cout << "Display (cold):        " << displayNanos / config.displays << " ns per product" << endl;
+    }
+    return stats.residentBytes <= config.budget ? 0 : 1;
+}
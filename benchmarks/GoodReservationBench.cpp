@@ -0,0 +1,124 @@
+// Contention on one hot Good: threads reserve/commit, reserve/release, abandon holds,
+// sell and backorder while a restocker adds stock. Checks that no unit is lost or
+// double-counted once the run settles.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/GoodReservationBench.cpp Product.cpp ColdText.cpp TextDictionary.cpp Stats.cpp -o goodReservationBench
+// Usage: goodReservationBench [millisPerRun] [maxThreads]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../Product.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    int millisPerRun = argc > 1 ? atoi(argv[1]) : 1000;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : static_cast<int>(thread::hardware_concurrency());
+    if (maxThreads <= 0) {
+        maxThreads = 1;
+    }
+
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    cout << setw(8) << "threads" << setw(14) << "ops/s" << setw(12) << "committed" << setw(10) << "expired"
+         << setw(12) << "backorders" << setw(8) << "filled" << setw(14) << "conservation" << endl;
+    bool allConserved = true;
+    for (int threads : threadCounts) {
+        const int initialStock = 1000;
+        Good good("hot sku", "contended good", "2030-01-01", initialStock);
+        atomic<bool> running(true);
+        atomic<uint64_t> operations(0);
+        atomic<long long> restocked(0);
+        atomic<int> committed(0);
+        atomic<int> backordersPlaced(0);
+        atomic<int> backordersFilled(0);
+
+        // Restocker: steady trickle of new units
+        thread restocker([&] {
+            while (running.load(memory_order_relaxed)) {
+                good.restock(25);
+                restocked.fetch_add(25);
+                this_thread::sleep_for(chrono::microseconds(200));
+            }
+        });
+
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                uint32_t seed = 2654435761u * (t + 1);
+                uint64_t done = 0;
+                vector<bool> accepted;
+                while (running.load(memory_order_relaxed)) {
+                    seed = seed * 1664525u + 1013904223u;
+                    int units = 1 + (seed >> 28) % 3;
+                    switch ((seed >> 20) % 8) {
+                        case 0: case 1: case 2: {
+                            shared_ptr<Reservation> hold = good.reserve(units);
+                            if (hold && good.commit(hold)) {
+                                committed.fetch_add(1, memory_order_relaxed);
+                            }
+                            break;
+                        }
+                        case 3: case 4: {
+                            shared_ptr<Reservation> hold = good.reserve(units);
+                            good.release(hold);
+                            break;
+                        }
+                        case 5:
+                            // Abandoned checkout: left for the expiry sweep
+                            good.reserve(units, chrono::milliseconds(1));
+                            break;
+                        case 6:
+                            good.sellBatch(vector<int>(1, units), accepted);
+                            break;
+                        case 7:
+                            if ((seed >> 8) % 64 == 0) {
+                                backordersPlaced.fetch_add(1, memory_order_relaxed);
+                                good.placeBackorder(units, [&backordersFilled](bool filled) {
+                                    if (filled) {
+                                        backordersFilled.fetch_add(1, memory_order_relaxed);
+                                    }
+                                });
+                            }
+                            break;
+                    }
+                    done++;
+                }
+                operations.fetch_add(done);
+            });
+        }
+
+        this_thread::sleep_for(chrono::milliseconds(millisPerRun));
+        running.store(false);
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        restocker.join();
+
+        // Let the abandoned holds lapse, then every unit must be available or sold
+        this_thread::sleep_for(chrono::milliseconds(5));
+        int expired = good.expireReservations();
+        long long accountedFor = static_cast<long long>(good.getQuantity()) + good.getReservedQuantity()
+                               + good.getSoldCount();
+        bool conserved = good.getReservedQuantity() == 0 && accountedFor == initialStock + restocked.load();
+        allConserved = allConserved && conserved;
+
+        cout << setw(8) << threads << setw(14) << fixed << setprecision(0)
+             << operations.load() / (millisPerRun / 1000.0) << setw(12) << committed.load()
+             << setw(10) << expired << setw(12) << backordersPlaced.load()
+             << setw(8) << backordersFilled.load() << setw(14) << (conserved ? "ok" : "VIOLATED") << endl;
+    }
+    return allConserved ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// Per-element-type cost of LinkedBag's bulk operations: trivially copyable items
+// (pooled nodes, pre-sized toVector) next to the same payloads on the generic path.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/LinkedBagItemTypeBench.cpp Trace.cpp -o linkedBagItemTypeBench
+// Usage: linkedBagItemTypeBench [items] [rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../LinkedBagDS/LinkedBag.h"
+#include "../Product.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+// Same payload as T, but with a user-provided copy so LinkedBag takes the generic path
+template<class T>
+struct Generic {
+    T value;
+    Generic() : value() {}
+    Generic(const T& v) : value(v) {}
+    Generic(const Generic& other) : value(other.value) {}
+    Generic& operator=(const Generic& other) { value = other.value; return *this; }
+    bool operator==(const Generic& other) const { return value == other.value; }
+};
+
+int makeItem(int i, int*) { return i; }
+Product* makeItem(int i, Product**) { return reinterpret_cast<Product*>(static_cast<size_t>(i + 1) * 64); }
+string makeItem(int i, string*) { return "product-name-" + to_string(i); }
+template<class T>
+Generic<T> makeItem(int i, Generic<T>*) { return Generic<T>(makeItem(i, static_cast<T*>(nullptr))); }
+
+struct Timings {
+    double add;
+    double copy;
+    double toVector;
+    double scan;
+    double clear;
+};
+
+double nanosPerItem(Clock::time_point start, int items) {
+    return chrono::duration<double, nano>(Clock::now() - start).count() / items;
+}
+
+template<class T>
+Timings run(int items, int rounds) {
+    vector<T> source;
+    source.reserve(items);
+    for (int i = 0; i < items; i++) {
+        source.push_back(makeItem(i, static_cast<T*>(nullptr)));
+    }
+
+    Timings best = {1e18, 1e18, 1e18, 1e18, 1e18};
+    size_t checksum = 0;
+    for (int r = 0; r < rounds; r++) {
+        LinkedBag<T> bag;
+        Clock::time_point start = Clock::now();
+        for (const T& item : source) {
+            bag.add(item);
+        }
+        best.add = min(best.add, nanosPerItem(start, items));
+
+        start = Clock::now();
+        LinkedBag<T> copy(bag);
+        best.copy = min(best.copy, nanosPerItem(start, items));
+
+        start = Clock::now();
+        vector<T> contents = copy.toVector();
+        best.toVector = min(best.toVector, nanosPerItem(start, items));
+        checksum += contents.size();
+
+        start = Clock::now();
+        checksum += bag.getFrequencyOf(source[items / 2]);
+        best.scan = min(best.scan, nanosPerItem(start, items));
+
+        start = Clock::now();
+        copy.clear();
+        bag.clear();
+        best.clear = min(best.clear, nanosPerItem(start, 2 * items));
+    }
+    if (checksum == 0) {
+        cout << "";
+    }
+    return best;
+}
+
+template<class T>
+void report(const char* name, int items, int rounds) {
+    Timings t = run<T>(items, rounds);
+    cout << setw(18) << name << setw(10) << sizeof(Node<T>) << setw(10) << t.add << setw(10) << t.copy
+         << setw(10) << t.toVector << setw(10) << t.scan << setw(10) << t.clear << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int items = argc > 1 ? atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+
+    cout << items << " items, best of " << rounds << " rounds, ns per item" << endl;
+    cout << setw(18) << "item type" << setw(10) << "node B" << setw(10) << "add" << setw(10) << "copy"
+         << setw(10) << "toVector" << setw(10) << "scan" << setw(10) << "clear" << endl;
+    cout << fixed << setprecision(1);
+    report<int>("int", items, rounds);
+    report<Generic<int> >("int (generic)", items, rounds);
+    report<Product*>("Product*", items, rounds);
+    report<Generic<Product*> >("Product* (generic)", items, rounds);
+    report<string>("string", items, rounds);
+    return 0;
+}
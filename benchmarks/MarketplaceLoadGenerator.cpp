@@ -0,0 +1,313 @@
+// Synthetic marketplace load: N vendors with M products each, driven by a seeded,
+// Zipf-skewed mix of create/display/sell/modify/delete through the Vendor API.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/MarketplaceLoadGenerator.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o marketplaceLoadGenerator
+// Usage: marketplaceLoadGenerator [--vendors N] [--products M] [--ops K | --seconds S]
+//                                 [--seed X] [--zipf s] [--mix create,display,sell,modify,delete]
+//   --mix takes relative weights, e.g. --mix 5,40,40,10,5 (the default).
+//   Runs with the same seed and --ops perform the same operation sequence.
+//   Product output and modify prompts are discarded; the report goes to stdout.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+enum Operation { Create, Display, Sell, Modify, Delete, OPERATION_COUNT };
+const char* const operationNames[OPERATION_COUNT] = {"create", "display", "sell", "modify", "delete"};
+
+struct Config {
+    int vendors = 8;
+    int products = 10000;
+    long long ops = 1000000;
+    double seconds = 0.0;   // When > 0, run for this long instead of a fixed op count
+    uint64_t seed = 42;
+    double zipf = 0.99;
+    int mix[OPERATION_COUNT] = {5, 40, 40, 10, 5};
+};
+
+// SplitMix64: tiny, fast and identical on every platform, unlike std:: distributions
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1)
+    double unit() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Uniform in [low, high]
+    int between(int low, int high) {
+        return low + static_cast<int>(next() % static_cast<uint64_t>(high - low + 1));
+    }
+
+    // Log-uniform in [low, high]: most values short, with a long tail
+    int skewedLength(int low, int high) {
+        return static_cast<int>(low * pow(static_cast<double>(high) / low, unit()));
+    }
+
+private:
+    uint64_t state;
+};
+
+// Samples ranks 0..n-1 with P(rank k) proportional to 1 / (k + 1)^s
+class ZipfSampler {
+public:
+    ZipfSampler(int n, double s) : cumulative(max(1, n)) {
+        double total = 0.0;
+        for (size_t k = 0; k < cumulative.size(); k++) {
+            total += 1.0 / pow(static_cast<double>(k + 1), s);
+            cumulative[k] = total;
+        }
+        for (double& c : cumulative) {
+            c /= total;
+        }
+    }
+
+    size_t sample(Random& random) const {
+        return lower_bound(cumulative.begin(), cumulative.end(), random.unit()) - cumulative.begin();
+    }
+
+private:
+    vector<double> cumulative;
+};
+
+const char* const words[] = {
+    "classic", "wireless", "organic", "deluxe", "portable", "vintage", "smart", "compact",
+    "premium", "handmade", "edition", "collection", "series", "kit", "bundle", "pack",
+    "guide", "album", "novel", "charger", "blend", "coffee", "notebook", "lamp"
+};
+const int WORD_COUNT = sizeof(words) / sizeof(words[0]);
+
+string makeText(Random& random, int length) {
+    string text;
+    text.reserve(length + 12);
+    while (static_cast<int>(text.size()) < length) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += words[random.next() % WORD_COUNT];
+    }
+    text.resize(length);
+    return text;
+}
+
+// Names are short with a few long outliers; descriptions range from a line to a few paragraphs
+Product* makeProduct(Random& random, long long serial) {
+    string name = makeText(random, random.skewedLength(6, 80)) + " #" + to_string(serial);
+    string description = makeText(random, random.skewedLength(20, 2000));
+    int rating = random.between(0, 5);
+    if (random.next() % 2 == 0) {
+        static const char* const types[] = {"book", "music", "movie", "game"};
+        static const char* const audiences[] = {"all", "kids", "teens", "adults"};
+        return new Media(name, description, types[random.next() % 4], audiences[random.next() % 4], rating, 0);
+    }
+    return new Good(name, description, "2030-01-" + to_string(random.between(10, 28)),
+                    random.between(0, 500), rating, 0);
+}
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+double percentile(vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--vendors") {
+            config.vendors = max(1, atoi(value));
+        } else if (flag == "--products") {
+            config.products = max(1, atoi(value));
+        } else if (flag == "--ops") {
+            config.ops = max(1LL, atoll(value));
+            config.seconds = 0.0;
+        } else if (flag == "--seconds") {
+            config.seconds = atof(value);
+        } else if (flag == "--seed") {
+            config.seed = strtoull(value, nullptr, 10);
+        } else if (flag == "--zipf") {
+            config.zipf = atof(value);
+        } else if (flag == "--mix") {
+            stringstream weights(value);
+            string weight;
+            for (int op = 0; op < OPERATION_COUNT; op++) {
+                config.mix[op] = getline(weights, weight, ',') ? max(0, atoi(weight.c_str())) : 0;
+            }
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    int mixTotal = 0;
+    for (int op = 0; op < OPERATION_COUNT; op++) {
+        mixTotal += config.mix[op];
+    }
+    if (mixTotal == 0) {
+        cerr << "The operation mix must have a positive weight" << endl;
+        return 1;
+    }
+
+    Random random(config.seed);
+    long long serial = 0;
+
+    // Each vendor's products by popularity rank: ids[v][0] is the hottest
+    vector<Vendor*> vendors;
+    vector<vector<ProductId> > ids(config.vendors);
+    Clock::time_point buildStart = Clock::now();
+    for (int v = 0; v < config.vendors; v++) {
+        Vendor* vendor = new Vendor("vendor" + to_string(v), "v" + to_string(v) + "@example.com",
+                                    "secret", makeText(random, random.skewedLength(20, 400)), "pic.png");
+        for (int p = 0; p < config.products; p++) {
+            Product* product = makeProduct(random, serial++);
+            vendor->createProduct(product);
+            ids[v].push_back(product->getId());
+        }
+        vendors.push_back(vendor);
+    }
+    double buildSeconds = chrono::duration<double>(Clock::now() - buildStart).count();
+    ZipfSampler popularity(config.products, config.zipf);
+
+    // Product output and modify prompts go nowhere; modify reads scripted answers
+    NullBuffer discard;
+    streambuf* savedOut = cout.rdbuf(&discard);
+    istringstream answers;
+    streambuf* savedIn = cin.rdbuf(answers.rdbuf());
+
+    vector<vector<double> > latencies(OPERATION_COUNT);
+    vector<long long> failures(OPERATION_COUNT, 0);
+    long long done = 0;
+    Clock::time_point runStart = Clock::now();
+    Clock::time_point deadline = runStart + chrono::duration_cast<Clock::duration>(chrono::duration<double>(config.seconds));
+
+    while (config.seconds > 0.0 ? Clock::now() < deadline : done < config.ops) {
+        // Choose the operation, vendor and (by popularity) product before timing
+        int pick = static_cast<int>(random.next() % mixTotal);
+        int op = 0;
+        while (pick >= config.mix[op]) {
+            pick -= config.mix[op++];
+        }
+        int v = static_cast<int>(random.next() % config.vendors);
+        vector<ProductId>& vendorIds = ids[v];
+        if (vendorIds.empty() && op != Create) {
+            op = Create;
+        }
+        size_t rank = vendorIds.empty() ? 0 : popularity.sample(random) % vendorIds.size();
+        Product* fresh = nullptr;
+        if (op == Create) {
+            fresh = makeProduct(random, serial++);
+        } else if (op == Modify) {
+            answers.str("\n" + makeText(random, random.skewedLength(20, 2000)) + "\n"
+                        + to_string(random.between(0, 5)) + "\n\n" + to_string(random.between(0, 500)) + "\n");
+            answers.clear();
+        }
+        int quantity = random.between(1, 3);
+
+        Clock::time_point start = Clock::now();
+        bool ok = true;
+        switch (op) {
+            case Create:
+                ok = vendors[v]->createProduct(fresh);
+                break;
+            case Display:
+                vendors[v]->displayProductById(vendorIds[rank]);
+                break;
+            case Sell:
+                ok = vendors[v]->sellProductById(vendorIds[rank], quantity);
+                break;
+            case Modify:
+                ok = vendors[v]->modifyProductById(vendorIds[rank]);
+                break;
+            case Delete:
+                ok = vendors[v]->deleteProductById(vendorIds[rank]);
+                break;
+        }
+        latencies[op].push_back(chrono::duration<double, nano>(Clock::now() - start).count());
+
+        // Keep the popularity list in step: new products start cold, deleted ones leave
+        if (op == Create) {
+            if (ok) {
+                vendorIds.push_back(fresh->getId());
+            } else {
+                delete fresh;
+            }
+        } else if (op == Delete && ok) {
+            vendorIds.erase(vendorIds.begin() + rank);
+        }
+        if (!ok) {
+            failures[op]++;
+        }
+        done++;
+    }
+    double runSeconds = chrono::duration<double>(Clock::now() - runStart).count();
+    cout.rdbuf(savedOut);
+    cin.rdbuf(savedIn);
+
+    cout << config.vendors << " vendors x " << config.products << " products (built in "
+         << fixed << setprecision(2) << buildSeconds << " s), seed " << config.seed
+         << ", zipf " << config.zipf << endl;
+    cout << done << " operations in " << runSeconds << " s: "
+         << setprecision(0) << done / runSeconds << " ops/s" << endl;
+    cout << setw(9) << "op" << setw(10) << "count" << setw(10) << "failed" << setw(10) << "p50 ns"
+         << setw(10) << "p90 ns" << setw(10) << "p99 ns" << setw(11) << "p99.9 ns" << setw(11) << "max ns" << endl;
+    for (int op = 0; op < OPERATION_COUNT; op++) {
+        vector<double>& samples = latencies[op];
+        cout << setw(9) << operationNames[op] << setw(10) << samples.size() << setw(10) << failures[op]
+             << setw(10) << percentile(samples, 0.50) << setw(10) << percentile(samples, 0.90)
+             << setw(10) << percentile(samples, 0.99) << setw(11) << percentile(samples, 0.999)
+             << setw(11) << (samples.empty() ? 0.0 : *max_element(samples.begin(), samples.end())) << endl;
+    }
+
+    for (Vendor* vendor : vendors) {
+        delete vendor;
+    }
+    return 0;
+}
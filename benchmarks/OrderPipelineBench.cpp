@@ -0,0 +1,116 @@
+// Throughput and tail latency of OrderPipeline across worker counts and batch sizes.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/OrderPipelineBench.cpp OrderPipeline.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o orderPipelineBench
+// Usage: orderPipelineBench [ordersPerProducer] [producers] [products]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../OrderPipeline.h"
+#include "../Product.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct RunResult {
+    double ordersPerSecond;
+    double p50Micros;
+    double p99Micros;
+    double p999Micros;
+    double ordersPerBatch;
+};
+
+double percentile(vector<uint64_t>& sorted, double p) {
+    size_t rank = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[rank] / 1000.0;
+}
+
+RunResult run(int workers, int batchSize, int producers, int ordersPerProducer, int productCount) {
+    vector<Good*> products;
+    for (int i = 0; i < productCount; i++) {
+        products.push_back(new Good("SKU" + to_string(i), "bench item", "2030-01-01", 1 << 30));
+    }
+
+    size_t total = static_cast<size_t>(producers) * ordersPerProducer;
+    vector<uint64_t> latencies(total, 0);
+    atomic<size_t> completed(0);
+
+    Clock::time_point start = Clock::now();
+    size_t batches = 0;
+    {
+        OrderPipeline pipeline(workers, batchSize, 8192);
+        vector<thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                uint32_t seed = 2654435761u * (p + 1);
+                for (int i = 0; i < ordersPerProducer; i++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    Good* product = products[(seed >> 8) % productCount];
+                    size_t id = static_cast<size_t>(p) * ordersPerProducer + i;
+                    Clock::time_point submitted = Clock::now();
+                    pipeline.submit(product, 1, [&, id, submitted](bool) {
+                        latencies[id] = static_cast<uint64_t>(
+                            chrono::duration_cast<chrono::nanoseconds>(Clock::now() - submitted).count());
+                        completed.fetch_add(1, memory_order_relaxed);
+                    });
+                }
+            });
+        }
+        for (thread& t : threads) {
+            t.join();
+        }
+        pipeline.shutdown();
+        batches = pipeline.getBatchesApplied();
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    for (Good* product : products) {
+        delete product;
+    }
+
+    sort(latencies.begin(), latencies.end());
+    RunResult result;
+    result.ordersPerSecond = completed.load() / seconds;
+    result.p50Micros = percentile(latencies, 0.50);
+    result.p99Micros = percentile(latencies, 0.99);
+    result.p999Micros = percentile(latencies, 0.999);
+    result.ordersPerBatch = batches == 0 ? 0.0 : static_cast<double>(total) / batches;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int ordersPerProducer = argc > 1 ? atoi(argv[1]) : 100000;
+    int producers = argc > 2 ? atoi(argv[2]) : 4;
+    int productCount = argc > 3 ? atoi(argv[3]) : 16;
+
+    const int workerCounts[] = {1, 2, 4, 8};
+    const int batchSizes[] = {1, 8, 64, 256};
+
+    cout << producers << " producers x " << ordersPerProducer << " orders over "
+         << productCount << " products" << endl;
+    cout << setw(8) << "workers" << setw(8) << "batch" << setw(14) << "orders/s"
+         << setw(12) << "p50(us)" << setw(12) << "p99(us)" << setw(12) << "p999(us)"
+         << setw(14) << "orders/apply" << endl;
+    cout << fixed << setprecision(1);
+    for (int workers : workerCounts) {
+        for (int batchSize : batchSizes) {
+            RunResult r = run(workers, batchSize, producers, ordersPerProducer, productCount);
+            cout << setw(8) << workers << setw(8) << batchSize << setw(14) << r.ordersPerSecond
+                 << setw(12) << r.p50Micros << setw(12) << r.p99Micros << setw(12) << r.p999Micros
+                 << setw(14) << r.ordersPerBatch << endl;
+        }
+    }
+    return 0;
+}
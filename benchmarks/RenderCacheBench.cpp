@@ -0,0 +1,116 @@
+// Cost of repeat product listings with and without the render cache: formatting
+// every field each time, refilling the cache after a change, and copying the
+// cached text.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/RenderCacheBench.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o renderCacheBench
+// Usage: renderCacheBench [products] [passes]
+//   "cold" touches every product (a setter storing the same rating) before it
+//   is displayed, so each display renders again; "warm" lists unchanged products.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "../Stats.h"
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+// Counts and discards everything written to it
+class NullBuffer : public streambuf {
+public:
+    uint64_t bytes = 0;
+
+protected:
+    int overflow(int c) override {
+        bytes++;
+        return c;
+    }
+    streamsize xsputn(const char*, streamsize n) override {
+        bytes += static_cast<uint64_t>(n);
+        return n;
+    }
+};
+
+struct Result {
+    double nanosPerProduct;
+    uint64_t hits;
+    uint64_t misses;
+};
+
+// Runs passes over the products and returns the cost per displayed product
+template<typename Display>
+Result measure(const vector<Product*>& products, int passes, Display display) {
+    uint64_t startHits = Stats::total(StatsCounter::RenderHit);
+    uint64_t startMisses = Stats::total(StatsCounter::RenderMiss);
+    Clock::time_point start = Clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (Product* product : products) {
+            display(product);
+        }
+    }
+    double nanos = chrono::duration<double, nano>(Clock::now() - start).count();
+    return Result{nanos / (static_cast<double>(products.size()) * passes),
+                  Stats::total(StatsCounter::RenderHit) - startHits,
+                  Stats::total(StatsCounter::RenderMiss) - startMisses};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int productCount = (argc > 1) ? max(1, atoi(argv[1])) : 10000;
+    int passes = (argc > 2) ? max(1, atoi(argv[2])) : 20;
+
+    Vendor vendor("bench", "bench@example.com", "secret", "Render cache bench vendor", "pic.png");
+    for (int p = 0; p < productCount; p++) {
+        string name = "Catalog product number " + to_string(p);
+        string description = "Description of product " + to_string(p) + ", as shown in every listing.";
+        if (p % 2 == 0) {
+            vendor.createProduct(new Media(name, description, "book", "adults", p % 6, p, 999 + p));
+        } else {
+            vendor.createProduct(new Good(name, description, "2030-01-01", 50, p % 6, p, 499 + p));
+        }
+    }
+    vector<Product*> products = vendor.getProducts();
+
+    NullBuffer discard;
+    streambuf* savedOut = cout.rdbuf(&discard);
+
+    Result uncached = measure(products, passes, [](Product* product) { product->render(cout); });
+    uint64_t uncachedBytes = discard.bytes;
+    Result cold = measure(products, passes, [](Product* product) {
+        product->setRating(product->getRating());
+        product->display();
+    });
+    uint64_t coldBytes = discard.bytes - uncachedBytes;
+    Result warm = measure(products, passes, [](Product* product) { product->display(); });
+    uint64_t warmBytes = discard.bytes - uncachedBytes - coldBytes;
+
+    cout.rdbuf(savedOut);
+
+    cout << productCount << " products, " << passes << " listings each" << endl;
+    cout << setw(10) << "listing" << setw(14) << "ns/product" << setw(10) << "hits"
+         << setw(10) << "misses" << setw(12) << "hit ratio" << endl;
+    const pair<const char*, Result> rows[] = {{"uncached", uncached}, {"cold", cold}, {"warm", warm}};
+    for (const pair<const char*, Result>& row : rows) {
+        uint64_t displays = row.second.hits + row.second.misses;
+        cout << setw(10) << row.first << setw(14) << fixed << setprecision(1) << row.second.nanosPerProduct
+             << setw(10) << row.second.hits << setw(10) << row.second.misses << setw(11)
+             << (displays == 0 ? 0.0 : 100.0 * row.second.hits / displays) << "%" << endl;
+    }
+    cout << "Warm speedup over uncached: " << setprecision(2)
+         << uncached.nanosPerProduct / warm.nanosPerProduct << "x" << endl;
+
+    // Every listing must print the same bytes
+    return (coldBytes == uncachedBytes && warmBytes == uncachedBytes) ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// Shared-memory catalog: one writer process publishes a vendor's catalog while
+// forked reader processes search it from their own read-only mappings. Reports
+// the publish cost, reader search latency and scan throughput next to
+// Vendor::searchProducts in the writer, and how often readers had to retry.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/SharedCatalogBench.cpp SharedCatalog.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o sharedCatalogBench
+// Usage: sharedCatalogBench [--products N] [--readers R] [--searches S] [--seed X]
+//   While the readers run, the writer keeps selling and republishing.
+//   Every reader checks its match counts against the writer's own search;
+//   the exit status is 1 if any differ.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../SharedCatalog.h"
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct Config {
+    int products = 100000;
+    int readers = 2;
+    int searches = 50;
+    uint64_t seed = 42;
+};
+
+// SplitMix64, as in the load generator
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+const char* const words[] = {"fresh", "durable", "classic", "limited", "organic", "premium",
+                             "compact", "deluxe", "portable", "vintage", "smart", "handmade"};
+
+string makeText(Random& random, size_t length) {
+    string text;
+    while (text.size() < length) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += words[random.next() % 12];
+    }
+    text.resize(length);
+    return text;
+}
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+// What a reader process sends back through its pipe
+struct ReaderResult {
+    double searchNanos;      ///< Mean time per search
+    double scannedBytes;     ///< Name and description bytes per search
+    uint64_t retries;        ///< Searches rerun after a concurrent publish
+    uint64_t version;        ///< Version the reader saw last
+    int mismatches;          ///< Searches whose match count differed from the writer's
+};
+
+// Search terms with a known match count; names never change during the run
+vector<string> makeTerms(Random& random, int count, int products) {
+    vector<string> terms;
+    for (int t = 0; t < count; t++) {
+        terms.push_back((t % 2 == 0) ? "Product " + to_string(random.next() % products)
+                                     : string(words[t % 12]) + " " + words[(t / 2) % 12] + " " + words[t % 5]);
+    }
+    return terms;
+}
+
+ReaderResult runReader(const string& name, const vector<string>& terms, const vector<size_t>& expected) {
+    ReaderResult result{0.0, 0.0, 0, 0, 0};
+    SharedCatalogReader reader;
+    if (!reader.open(name)) {
+        result.mismatches = static_cast<int>(terms.size());
+        return result;
+    }
+    vector<ProductId> matches;
+    Clock::time_point start = Clock::now();
+    for (size_t t = 0; t < terms.size(); t++) {
+        if (reader.searchProducts(terms[t], matches) != expected[t]) {
+            result.mismatches++;
+        }
+    }
+    result.searchNanos = chrono::duration<double, nano>(Clock::now() - start).count() / terms.size();
+    result.retries = reader.getRetries();
+
+    // The bytes a search walks, and the latest version
+    reader.read([&](const SharedCatalogView& view) {
+        double bytes = 0.0;
+        for (size_t i = 0; i < view.size(); i++) {
+            bytes += view.at(i).getName().size() + view.at(i).getDescription().size();
+        }
+        result.scannedBytes = bytes;
+        result.version = view.getVersion();
+    });
+    return result;
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--products") {
+            config.products = max(1, atoi(value));
+        } else if (flag == "--readers") {
+            config.readers = max(1, atoi(value));
+        } else if (flag == "--searches") {
+            config.searches = max(1, atoi(value));
+        } else if (flag == "--seed") {
+            config.seed = strtoull(value, nullptr, 10);
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+
+    Random random(config.seed);
+    Vendor vendor("bench", "bench@example.com", "secret", "Shared catalog bench vendor", "pic.png");
+    size_t textBytes = 0;
+    for (int p = 0; p < config.products; p++) {
+        string name = "Product " + to_string(p);
+        string description = makeText(random, 50 + random.next() % 300);
+        textBytes += name.size() + description.size();
+        Product* product = (p % 2 == 0)
+            ? static_cast<Product*>(new Media(name, description, "book", "all", p % 6, 0, 999))
+            : static_cast<Product*>(new Good(name, description, "2030-01-01", 1 << 30, p % 6, 0, 499));
+        vendor.createProduct(product);
+    }
+
+    // The writer's own answers, timed with the same terms
+    vector<string> terms = makeTerms(random, config.searches, config.products);
+    vector<size_t> expected;
+    vector<Product*> found;
+    Clock::time_point localStart = Clock::now();
+    for (const string& term : terms) {
+        expected.push_back(vendor.searchProducts(term, found));
+    }
+    double localNanos = chrono::duration<double, nano>(Clock::now() - localStart).count() / terms.size();
+
+    string name = "/amazon340-bench-" + to_string(getpid());
+    SharedCatalogWriter writer;
+    size_t slotBytes = config.products * sizeof(SharedProductEntry) + textBytes * 2 + (1 << 20);
+    if (!writer.create(name, slotBytes)) {
+        return 1;
+    }
+    Clock::time_point publishStart = Clock::now();
+    if (!writer.publish(vendor)) {
+        return 1;
+    }
+    double publishMillis = chrono::duration<double, milli>(Clock::now() - publishStart).count();
+
+    vector<pid_t> children;
+    vector<int> pipes;
+    for (int r = 0; r < config.readers; r++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return 1;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            ReaderResult result = runReader(name, terms, expected);
+            ssize_t written = write(fds[1], &result, sizeof(result));
+            _exit(written == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+        }
+        close(fds[1]);
+        children.push_back(pid);
+        pipes.push_back(fds[0]);
+    }
+
+    // Keep selling and republishing until every reader has finished
+    NullBuffer discard;
+    streambuf* savedOut = cout.rdbuf(&discard);
+    int publishes = 0;
+    size_t running = children.size();
+    while (running > 0) {
+        for (int s = 0; s < 100; s++) {
+            vendor.sellProduct(static_cast<int>(random.next() % min(config.products, 1000)) + 1, 1);
+        }
+        writer.publish(vendor);
+        publishes++;
+        running = 0;
+        for (pid_t& pid : children) {
+            if (pid > 0 && waitpid(pid, nullptr, WNOHANG) == 0) {
+                running++;
+            } else {
+                pid = 0;
+            }
+        }
+    }
+    cout.rdbuf(savedOut);
+
+    cout << config.products << " products, " << textBytes << " bytes of names and descriptions; slot "
+         << slotBytes << " bytes" << endl;
+    cout << fixed << setprecision(1);
+    cout << "Publish: " << publishMillis << " ms for the whole catalog; " << publishes
+         << " republished while the readers ran" << endl;
+    cout << endl;
+    cout << setw(20) << "" << setw(16) << "search (us)" << setw(14) << "scan (GB/s)" << setw(10) << "retries"
+         << setw(12) << "version" << endl;
+    cout << setw(20) << "Vendor (writer)" << setw(16) << localNanos / 1000.0 << setw(14)
+         << textBytes / localNanos << setw(10) << "-" << setw(12) << "-" << endl;
+    bool correct = true;
+    for (int r = 0; r < config.readers; r++) {
+        ReaderResult result;
+        if (read(pipes[r], &result, sizeof(result)) != static_cast<ssize_t>(sizeof(result))) {
+            cout << "Reader " << r << " did not report" << endl;
+            correct = false;
+            continue;
+        }
+        close(pipes[r]);
+        cout << setw(20) << ("reader process " + to_string(r)) << setw(16) << result.searchNanos / 1000.0
+             << setw(14) << result.scannedBytes / result.searchNanos << setw(10) << result.retries
+             << setw(12) << result.version << endl;
+        if (result.mismatches != 0) {
+            cout << "Reader " << r << ": " << result.mismatches << " searches disagreed with the writer" << endl;
+            correct = false;
+        }
+    }
+    return correct ? 0 : 1;
+}
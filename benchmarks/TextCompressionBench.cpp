@@ -0,0 +1,250 @@
+// Dictionary compression of product descriptions: compression ratio with and
+// without a trained dictionary, compression and decompression throughput, and
+// the same descriptions served through the cold text store behind getDescription().
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/TextCompressionBench.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o textCompressionBench
+// Usage: textCompressionBench [--products N] [--samples S] [--dictionary BYTES] [--budget BYTES] [--seed X]
+//   Descriptions mix product-specific words with shared marketing sentences and
+//   one of 50 vendor signatures. The dictionary is trained on the first S descriptions.
+//   The exit status is 1 if any description fails to round-trip.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../ColdText.h"
+#include "../TextDictionary.h"
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct Config {
+    int products = 100000;
+    int samples = 10000;
+    size_t dictionary = 16384;
+    size_t budget = 1 << 20;
+    uint64_t seed = 42;
+};
+
+// SplitMix64, as in the load generator
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    int between(int low, int high) {
+        return low + static_cast<int>(next() % static_cast<uint64_t>(high - low + 1));
+    }
+
+private:
+    uint64_t state;
+};
+
+const char* const boilerplate[] = {
+    "Free standard shipping on all orders over $35, with easy returns within 30 days of delivery. ",
+    "Backed by our 100% satisfaction guarantee: if you are not completely happy, we will make it right. ",
+    "Please allow 2-3 business days for processing before your order ships. ",
+    "Customers who bought this item also enjoyed other products from our bestselling collection. ",
+    "Limited time offer while supplies last. Prices and availability are subject to change without notice. ",
+    "Each item is carefully inspected by our quality assurance team before it leaves the warehouse. ",
+    "Makes a perfect gift for birthdays, holidays, anniversaries and every special occasion. ",
+    "Questions? Our friendly support team is available seven days a week to help with your purchase. ",
+};
+const int BOILERPLATE_COUNT = sizeof(boilerplate) / sizeof(boilerplate[0]);
+
+class DescriptionGenerator {
+public:
+    explicit DescriptionGenerator(uint64_t seed) : random(seed) {
+        static const char* const syllables[] = {"ka", "lo", "mi", "ra", "ten", "vo", "shi", "pel", "dor", "an",
+                                                "qu", "ix", "bre", "tu", "sa", "ny", "gol", "fe", "zu", "wen"};
+        for (int w = 0; w < 3000; w++) {
+            string word;
+            int parts = random.between(2, 4);
+            for (int p = 0; p < parts; p++) {
+                word += syllables[random.next() % 20];
+            }
+            vocabulary.push_back(word);
+        }
+        for (int v = 0; v < 50; v++) {
+            signatures.push_back("-- Sold and shipped by " + vocabulary[random.next() % vocabulary.size()]
+                                 + " Trading Company, serving happy customers since "
+                                 + to_string(random.between(1990, 2020)) + ".");
+        }
+    }
+
+    string next() {
+        string text;
+        int sentences = random.between(1, 8);
+        for (int s = 0; s < sentences; s++) {
+            if (random.next() % 3 == 0) {
+                text += boilerplate[random.next() % BOILERPLATE_COUNT];
+                continue;
+            }
+            int words = random.between(5, 14);
+            for (int w = 0; w < words; w++) {
+                text += vocabulary[random.next() % vocabulary.size()];
+                text += (w + 1 < words) ? ' ' : '.';
+            }
+            text += ' ';
+        }
+        text += signatures[random.next() % signatures.size()];
+        return text;
+    }
+
+private:
+    Random random;
+    vector<string> vocabulary;
+    vector<string> signatures;
+};
+
+struct Measured {
+    size_t bytes = 0;
+    double compressSeconds = 0.0;
+    double decompressSeconds = 0.0;
+    bool roundTrips = true;
+};
+
+// Compresses every text, then decompresses every block and checks it
+Measured measure(const TextDictionary& dictionary, const vector<string>& texts) {
+    Measured result;
+    vector<string> blocks(texts.size());
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < texts.size(); i++) {
+        dictionary.compress(texts[i], blocks[i]);
+        result.bytes += blocks[i].size();
+    }
+    result.compressSeconds = chrono::duration<double>(Clock::now() - start).count();
+
+    string decoded;
+    start = Clock::now();
+    for (size_t i = 0; i < texts.size(); i++) {
+        decoded.resize(texts[i].size());
+        if (!dictionary.decompress(blocks[i], &decoded[0], decoded.size()) || decoded != texts[i]) {
+            result.roundTrips = false;
+        }
+    }
+    result.decompressSeconds = chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--products") {
+            config.products = max(1, atoi(value));
+        } else if (flag == "--samples") {
+            config.samples = max(1, atoi(value));
+        } else if (flag == "--dictionary") {
+            config.dictionary = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (flag == "--budget") {
+            config.budget = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (flag == "--seed") {
+            config.seed = strtoull(value, nullptr, 10);
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+
+    DescriptionGenerator generator(config.seed);
+    vector<string> texts;
+    size_t textBytes = 0;
+    for (int p = 0; p < config.products; p++) {
+        texts.push_back(generator.next());
+        textBytes += texts.back().size();
+    }
+
+    vector<string_view> samples(texts.begin(), texts.begin() + min<size_t>(texts.size(), config.samples));
+    Clock::time_point trainStart = Clock::now();
+    shared_ptr<const TextDictionary> dictionary = TextDictionary::train(samples, config.dictionary);
+    double trainMillis = chrono::duration<double, milli>(Clock::now() - trainStart).count();
+
+    TextDictionary none("");
+    Measured plain = measure(none, texts);
+    Measured trained = measure(*dictionary, texts);
+
+    cout << config.products << " descriptions, " << textBytes << " bytes (" << textBytes / config.products
+         << " per description)" << endl;
+    cout << "Dictionary: " << dictionary->size() << " bytes trained on " << samples.size() << " descriptions in "
+         << fixed << setprecision(1) << trainMillis << " ms" << endl;
+    cout << endl;
+    cout << setw(16) << "" << setw(14) << "compressed" << setw(8) << "ratio" << setw(16) << "compress MB/s"
+         << setw(18) << "decompress MB/s" << endl;
+    const pair<const char*, const Measured*> rows[] = {{"no dictionary", &plain}, {"trained", &trained}};
+    for (const pair<const char*, const Measured*>& row : rows) {
+        const Measured& m = *row.second;
+        cout << setw(16) << row.first << setw(14) << m.bytes << setw(7) << setprecision(2)
+             << static_cast<double>(textBytes) / m.bytes << "x" << setprecision(0)
+             << setw(16) << textBytes / m.compressSeconds / 1e6 << setw(18) << textBytes / m.decompressSeconds / 1e6
+             << endl;
+    }
+
+    // The same descriptions behind getDescription(), compressed as the budget evicts them
+    Vendor vendor("bench", "bench@example.com", "secret", "Compression bench vendor", "pic.png");
+    vector<Product*> products;
+    for (int p = 0; p < config.products; p++) {
+        Product* product = new Media("Product " + to_string(p), texts[p], "book", "all", p % 6, 0, 999);
+        vendor.createProduct(product);
+        products.push_back(product);
+    }
+    ColdTextStore::useDictionary(dictionary);
+    ColdTextStore::setBudget(config.budget);
+
+    bool served = true;
+    Random random(config.seed + 1);
+    int reads = min(config.products, 20000);
+    Clock::time_point readStart = Clock::now();
+    for (int r = 0; r < reads; r++) {
+        size_t index = random.next() % products.size();
+        if (products[index]->getDescription().text() != texts[index]) {
+            served = false;
+        }
+    }
+    double readNanos = chrono::duration<double, nano>(Clock::now() - readStart).count() / reads;
+
+    ColdTextStats stats = ColdTextStore::getStats();
+    cout << endl;
+    cout << "Through the cold text store (budget " << config.budget << " bytes):" << endl;
+    ColdTextStore::display(cout);
+    cout << "getDescription() on an evicted product: " << setprecision(0) << readNanos << " ns" << endl;
+    cout << "Description memory: " << stats.compressedBytes + stats.residentBytes << " bytes instead of "
+         << textBytes << endl;
+
+    bool correct = plain.roundTrips && trained.roundTrips && served;
+    if (!correct) {
+        cout << "Round trip FAILED" << endl;
+    }
+    return correct ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Scaling of catalog-wide maintenance on ThreadPool from 1 to N worker threads.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/ThreadPoolBench.cpp ThreadPool.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o threadPoolBench
+// Usage: threadPoolBench [vendors] [productsPerVendor] [maxThreads]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ThreadPool.h"
+#include "../Vendor.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+template<class Fn>
+double timeMillis(Fn fn) {
+    Clock::time_point start = Clock::now();
+    fn();
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int vendorCount = argc > 1 ? atoi(argv[1]) : 8;
+    int productsPerVendor = argc > 2 ? atoi(argv[2]) : 100000;
+    int maxThreads = argc > 3 ? atoi(argv[3]) : static_cast<int>(thread::hardware_concurrency());
+    if (maxThreads <= 0) {
+        maxThreads = 1;
+    }
+
+    vector<Vendor*> vendors;
+    for (int v = 0; v < vendorCount; v++) {
+        Vendor* vendor = new Vendor("vendor" + to_string(v), "v" + to_string(v) + "@example.com",
+                                    "secret", "bench vendor", "pic.png");
+        for (int p = 0; p < productsPerVendor; p++) {
+            if (p % 2 == 0) {
+                vendor->createProduct(new Media("media" + to_string(p), "a media product", "book", "all", p % 6, p));
+            } else {
+                vendor->createProduct(new Good("good" + to_string(p), "a physical good", "2030-01-01", 100, p % 6, p));
+            }
+        }
+        vendors.push_back(vendor);
+    }
+    const size_t grain = 2048;
+
+    cout << vendorCount << " vendors x " << productsPerVendor << " products, grain " << grain << endl;
+    cout << setw(8) << "threads" << setw(16) << "resetRatings" << setw(16) << "editDescr"
+         << setw(16) << "sumSold" << setw(10) << "speedup" << "  (ms)" << endl;
+    cout << fixed << setprecision(2);
+
+    // Powers of two up to maxThreads, always ending on maxThreads itself
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double baseline = 0.0;
+    for (int threads : threadCounts) {
+        ThreadPool pool(threads);
+
+        double reset = timeMillis([&] {
+            pool.forEachProduct(vendors, grain, [](Product* product) { product->setRating(0); });
+        });
+        double edit = timeMillis([&] {
+            pool.forEachProduct(vendors, grain, [](Product* product) {
+                product->setDescription(std::string(product->getName()) + " - updated listing");
+            });
+        });
+        long long sold = 0;
+        double sum = timeMillis([&] {
+            sold = pool.reduceProducts(vendors, grain, 0LL,
+                [](const Product* product) { return static_cast<long long>(product->getSoldCount()); },
+                [](long long a, long long b) { return a + b; });
+        });
+
+        double total = reset + edit + sum;
+        if (threads == 1) {
+            baseline = total;
+        }
+        cout << setw(8) << threads << setw(16) << reset << setw(16) << edit << setw(16) << sum
+             << setw(10) << baseline / total << "  (sold=" << sold << ")" << endl;
+    }
+
+    for (Vendor* vendor : vendors) {
+        delete vendor;
+    }
+    return 0;
+}
@@ -0,0 +1,402 @@
+// Local server load: C client connections, each keeping D pipelined requests in
+// flight against a VendorServer, measuring throughput and round-trip latency.
+//
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -pthread benchmarks/VendorServerBench.cpp VendorServer.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o vendorServerBench
+// Usage: vendorServerBench [--connections C] [--depth D] [--seconds S] [--products P]
+//                          [--sell PERCENT] [--unix PATH]
+//   Requests are KTH on a random product, or SELL of one unit for --sell percent
+//   of them (default 20). Without --unix the server listens on a TCP port of 127.0.0.1.
+//   The server runs on its own thread; one epoll thread drives every client.
+//   First, one client writes 300 LIST requests and a PING at once, and the
+//   run fails unless the final PONG arrives.
+
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../VendorServer.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct Config {
+    int connections = 64;
+    int depth = 16;
+    double seconds = 5.0;
+    int products = 1000;
+    int sellPercent = 20;
+    string unixPath;        // Empty for TCP
+};
+
+// SplitMix64, as in the marketplace load generator
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+// One client socket and the send times of its unanswered requests, oldest first
+struct Client {
+    int fd = -1;
+    string output;
+    size_t outputSent = 0;
+    deque<Clock::time_point> inFlight;
+    bool wantsWrite = false;
+};
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+double percentile(vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--connections") {
+            config.connections = max(1, atoi(value));
+        } else if (flag == "--depth") {
+            config.depth = max(1, atoi(value));
+        } else if (flag == "--seconds") {
+            config.seconds = max(0.1, atof(value));
+        } else if (flag == "--products") {
+            config.products = max(1, atoi(value));
+        } else if (flag == "--sell") {
+            config.sellPercent = min(100, max(0, atoi(value)));
+        } else if (flag == "--unix") {
+            config.unixPath = value;
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+// Both ends of every connection live in this process, so it needs two descriptors each
+void raiseDescriptorLimit(int connections) {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return;
+    }
+    rlim_t wanted = static_cast<rlim_t>(connections) * 2 + 64;
+    if (limit.rlim_cur < wanted) {
+        limit.rlim_cur = min(wanted, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (limit.rlim_cur < wanted) {
+        cerr << "Warning: descriptor limit " << limit.rlim_cur << " is below the " << wanted
+             << " this run needs" << endl;
+    }
+}
+
+int connectClient(const Config& config, int port) {
+    int fd;
+    if (config.unixPath.empty()) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    } else {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, config.unixPath.c_str(), sizeof(address.sun_path) - 1);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            return -1;
+        }
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+// Sends what the socket takes; false if the connection failed
+bool flushClient(Client& client) {
+    while (client.outputSent < client.output.size()) {
+        ssize_t sent = send(client.fd, client.output.data() + client.outputSent,
+                            client.output.size() - client.outputSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.outputSent += static_cast<size_t>(sent);
+    }
+    client.output.clear();
+    client.outputSent = 0;
+    return true;
+}
+
+// Writes lists LIST requests and a PING in one go and reads until the PONG;
+// false if it has not arrived within ten seconds
+bool checkPipelinedLists(const Config& config, int port, int lists, size_t& replyBytes) {
+    int fd = connectClient(config, port);
+    if (fd < 0) {
+        return false;
+    }
+    string requests;
+    for (int i = 0; i < lists; i++) {
+        requests += "LIST\n";
+    }
+    requests += "PING\n";
+    const string pong = "OK PONG\n";
+
+    size_t sent = 0;
+    string tail;  // The last bytes received, enough to spot the PONG
+    replyBytes = 0;
+    char buffer[64 * 1024];
+    Clock::time_point deadline = Clock::now() + chrono::seconds(10);
+    while (Clock::now() < deadline) {
+        if (sent < requests.size()) {
+            ssize_t written = send(fd, requests.data() + sent, requests.size() - sent, MSG_NOSIGNAL);
+            if (written > 0) {
+                sent += static_cast<size_t>(written);
+            }
+        }
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            break;
+        }
+        if (received < 0) {
+            this_thread::sleep_for(chrono::microseconds(100));
+            continue;
+        }
+        replyBytes += static_cast<size_t>(received);
+        tail.append(buffer, static_cast<size_t>(received));
+        if (tail.size() > pong.size()) {
+            tail.erase(0, tail.size() - pong.size());
+        }
+        if (sent == requests.size() && tail == pong) {
+            close(fd);
+            return true;
+        }
+    }
+    close(fd);
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    raiseDescriptorLimit(config.connections);
+
+    // Goods with enough stock that SELL never runs out during the run
+    Vendor vendor("bench", "bench@example.com", "secret", "Load test vendor", "pic.png");
+    NullBuffer discard;
+    streambuf* savedOut = cout.rdbuf(&discard);
+    for (int p = 0; p < config.products; p++) {
+        vendor.createProduct(new Good("Product #" + to_string(p), "Benchmark stock item", "2030-01-01",
+                                      1000000000, p % 6, 0, 199));
+    }
+    cout.rdbuf(savedOut);
+
+    VendorServer server(vendor);
+    bool listening = config.unixPath.empty() ? server.listenTcp(0) : server.listenUnix(config.unixPath);
+    if (!listening) {
+        return 1;
+    }
+    thread serverThread([&server] { server.run(); });
+
+    // Replies to a burst of LISTs exceed the server's output cap many times over
+    const int pipelinedLists = 300;
+    size_t pipelinedBytes = 0;
+    bool pipelined = checkPipelinedLists(config, server.getPort(), pipelinedLists, pipelinedBytes);
+
+    int epollFd = epoll_create1(0);
+    vector<Client> clients(config.connections);
+    for (int c = 0; c < config.connections; c++) {
+        clients[c].fd = connectClient(config, server.getPort());
+        if (clients[c].fd < 0) {
+            cerr << "Connection " << c << " failed: " << strerror(errno) << endl;
+            server.stop();
+            serverThread.join();
+            return 1;
+        }
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = static_cast<uint32_t>(c);
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, clients[c].fd, &event);
+    }
+
+    Random random(42);
+    vector<double> latencies;
+    latencies.reserve(1 << 20);
+    long long sells = 0;
+    long long errors = 0;
+    char buffer[64 * 1024];
+
+    // Tops a client up to the pipeline depth unless the run is over
+    bool sending = true;
+    auto fill = [&](Client& client) {
+        while (sending && client.inFlight.size() < static_cast<size_t>(config.depth)) {
+            int k = 1 + static_cast<int>(random.next() % static_cast<uint64_t>(config.products));
+            if (static_cast<int>(random.next() % 100) < config.sellPercent) {
+                client.output += "SELL " + to_string(k) + " 1\n";
+                sells++;
+            } else {
+                client.output += "KTH " + to_string(k) + "\n";
+            }
+            client.inFlight.push_back(Clock::now());
+        }
+    };
+    auto updateInterest = [&](Client& client, int index) {
+        bool wantsWrite = !client.output.empty();
+        if (wantsWrite != client.wantsWrite) {
+            epoll_event event;
+            event.events = EPOLLIN | (wantsWrite ? EPOLLOUT : 0u);
+            event.data.u32 = static_cast<uint32_t>(index);
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+            client.wantsWrite = wantsWrite;
+        }
+    };
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(config.seconds));
+    for (int c = 0; c < config.connections; c++) {
+        fill(clients[c]);
+        flushClient(clients[c]);
+        updateInterest(clients[c], c);
+    }
+
+    // Run until the deadline, then stop sending and collect what is still in flight
+    size_t outstanding = 0;
+    bool failed = false;
+    epoll_event events[256];
+    while (!failed) {
+        if (sending && Clock::now() >= deadline) {
+            sending = false;
+        }
+        if (!sending) {
+            outstanding = 0;
+            for (const Client& client : clients) {
+                outstanding += client.inFlight.size();
+            }
+            if (outstanding == 0) {
+                break;
+            }
+        }
+        int ready = epoll_wait(epollFd, events, 256, 100);
+        for (int e = 0; e < ready && !failed; e++) {
+            int index = static_cast<int>(events[e].data.u32);
+            Client& client = clients[index];
+            if (events[e].events & EPOLLIN) {
+                ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    cerr << "Connection " << index << " closed by the server" << endl;
+                    failed = true;
+                    break;
+                }
+                Clock::time_point now = Clock::now();
+                for (ssize_t i = 0; i < received; i++) {
+                    if (buffer[i] == 'E' && (i == 0 || buffer[i - 1] == '\n')) {
+                        errors++;
+                    }
+                    if (buffer[i] == '\n' && !client.inFlight.empty()) {
+                        latencies.push_back(chrono::duration<double, micro>(now - client.inFlight.front()).count());
+                        client.inFlight.pop_front();
+                    }
+                }
+                fill(client);
+            }
+            if (!flushClient(client)) {
+                cerr << "Connection " << index << " failed to send" << endl;
+                failed = true;
+                break;
+            }
+            updateInterest(client, index);
+        }
+    }
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+
+    for (Client& client : clients) {
+        close(client.fd);
+    }
+    close(epollFd);
+    server.stop();
+    serverThread.join();
+    if (failed) {
+        return 1;
+    }
+
+    long long soldUnits = 0;
+    for (int k = 1; k <= vendor.getProductCount(); k++) {
+        soldUnits += vendor.getKthProduct(k)->getSoldCount();
+    }
+
+    cout << "Transport:        " << (config.unixPath.empty() ? "tcp 127.0.0.1" : "unix " + config.unixPath) << endl;
+    cout << "Pipelined LIST:   " << pipelinedLists << " requests, " << pipelinedBytes << " reply bytes, "
+         << (pipelined ? "final PONG received" : "FAILED: no final PONG") << endl;
+    cout << "Connections:      " << config.connections << " x depth " << config.depth << endl;
+    cout << "Requests:         " << latencies.size() << " (" << sells << " sells, " << errors << " errors)" << endl;
+    cout << "Sold units:       " << soldUnits << endl;
+    cout << fixed << setprecision(0);
+    cout << "Throughput:       " << latencies.size() / elapsed << " req/s" << endl;
+    cout << setprecision(1);
+    cout << setw(10) << "p50 us" << setw(10) << "p99 us" << setw(11) << "p99.9 us" << setw(11) << "max us" << endl;
+    cout << setw(10) << percentile(latencies, 0.50) << setw(10) << percentile(latencies, 0.99)
+         << setw(11) << percentile(latencies, 0.999)
+         << setw(11) << (latencies.empty() ? 0.0 : *max_element(latencies.begin(), latencies.end())) << endl;
+    return (pipelined && soldUnits == sells && errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// Coroutine session multiplexing: N vendor menus driven from one thread, one
+// input line per session per round, so every session suspends between lines.
+//
+// Build from the repository root:
+//   g++ -std=c++20 -O2 -pthread benchmarks/VendorSessionBench.cpp Session.cpp VendorSession.cpp VendorServer.cpp Vendor.cpp Product.cpp ColdText.cpp TextDictionary.cpp CatalogSnapshot.cpp Stats.cpp Trace.cpp -o vendorSessionBench
+// Usage: vendorSessionBench [--sessions N] [--vendors V] [--cycles C]
+//   Sessions are spread round-robin over V vendors (default: one vendor per session).
+//   Each cycle creates a good, sells it, displays it, modifies it and deletes it.
+//   Memory is sampled after every round, while all sessions are suspended.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../VendorSession.h"
+
+using namespace std;
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+struct Config {
+    int sessions = 10000;
+    int vendors = 0;        // 0: one per session
+    int cycles = 10;
+};
+
+// One menu cycle, one input line per entry
+const char* const script[] = {
+    "3", "2", "Bench item", "Created by a session", "2030-01-01", "100", "4.99",   // create a good
+    "7", "1", "2",                                                                // sell two
+    "5", "1",                                                                     // display it
+    "6", "1", "", "Modified by a session", "4", "5.49", "", "98",                  // modify it
+    "8", "1",                                                                     // delete it
+};
+const size_t SCRIPT_LINES = sizeof(script) / sizeof(script[0]);
+
+// Per-round memory totals across all sessions
+struct Sample {
+    size_t frameBytes = 0;
+    size_t heapBytes = 0;
+    size_t maxFrameBytes = 0;
+};
+
+Sample sample(const vector<unique_ptr<VendorSession> >& sessions) {
+    Sample totals;
+    for (const unique_ptr<VendorSession>& session : sessions) {
+        totals.frameBytes += session->getFrameBytes();
+        totals.heapBytes += session->getHeapBytes();
+        totals.maxFrameBytes = max(totals.maxFrameBytes, session->getFrameBytes());
+    }
+    return totals;
+}
+
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--sessions") {
+            config.sessions = max(1, atoi(value));
+        } else if (flag == "--vendors") {
+            config.vendors = max(1, atoi(value));
+        } else if (flag == "--cycles") {
+            config.cycles = max(1, atoi(value));
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value for " << argv[argc - 1] << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    int vendorCount = (config.vendors == 0) ? config.sessions : min(config.vendors, config.sessions);
+
+    vector<unique_ptr<Vendor> > vendors;
+    for (int v = 0; v < vendorCount; v++) {
+        vendors.emplace_back(new Vendor("vendor" + to_string(v), "v" + to_string(v) + "@example.com",
+                                        "secret", "Session bench vendor", "pic.png"));
+    }
+    vector<unique_ptr<VendorSession> > sessions;
+    for (int s = 0; s < config.sessions; s++) {
+        sessions.emplace_back(new VendorSession(*vendors[s % vendorCount]));
+    }
+
+    // Every session shows its menu and suspends on the first read
+    size_t outputBytes = 0;
+    for (unique_ptr<VendorSession>& session : sessions) {
+        session->start();
+        outputBytes += session->takeOutput().size();
+    }
+    Sample atMenu = sample(sessions);
+
+    Sample peak;
+    size_t peakLine = 0;
+    long long linesFed = 0;
+    Clock::time_point start = Clock::now();
+    for (int cycle = 0; cycle < config.cycles; cycle++) {
+        for (size_t line = 0; line < SCRIPT_LINES; line++) {
+            string input = string(script[line]) + "\n";
+            for (unique_ptr<VendorSession>& session : sessions) {
+                session->feed(input);
+                outputBytes += session->takeOutput().size();
+            }
+            linesFed += static_cast<long long>(sessions.size());
+
+            Sample round = sample(sessions);
+            if (round.frameBytes > peak.frameBytes) {
+                peak = round;
+                peakLine = line;
+            }
+        }
+    }
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+
+    size_t waiting = 0;
+    for (const unique_ptr<VendorSession>& session : sessions) {
+        waiting += session->isWaitingForInput() ? 1 : 0;
+    }
+    size_t leftover = 0;
+    for (const unique_ptr<Vendor>& vendor : vendors) {
+        leftover += static_cast<size_t>(vendor->getProductCount());
+    }
+    for (unique_ptr<VendorSession>& session : sessions) {
+        session->closeInput();
+    }
+
+    double count = static_cast<double>(sessions.size());
+    cout << "Sessions:         " << sessions.size() << " over " << vendorCount << " vendors, one thread" << endl;
+    cout << "Lines fed:        " << linesFed << " (" << config.cycles << " cycles of " << SCRIPT_LINES << ")" << endl;
+    cout << "Output:           " << outputBytes << " bytes" << endl;
+    cout << fixed << setprecision(0);
+    cout << "Throughput:       " << linesFed / elapsed << " lines/s" << endl;
+    cout << "Still waiting:    " << waiting << ", products left: " << leftover << endl;
+    cout << endl;
+    cout << "Per suspended session (bytes; object is sizeof(VendorSession) = " << sizeof(VendorSession) << ")" << endl;
+    cout << setw(26) << "" << setw(10) << "frames" << setw(10) << "heap" << setw(12) << "max frames" << endl;
+    cout << setw(26) << "at the menu prompt" << setw(10) << atMenu.frameBytes / count
+         << setw(10) << atMenu.heapBytes / count << setw(12) << atMenu.maxFrameBytes << endl;
+    cout << setw(26) << ("peak, after \"" + string(script[peakLine]) + "\" (#" + to_string(peakLine + 1) + ")")
+         << setw(10) << peak.frameBytes / count << setw(10) << peak.heapBytes / count
+         << setw(12) << peak.maxFrameBytes << endl;
+    return (waiting == sessions.size() && leftover == 0) ? 0 : 1;
+}